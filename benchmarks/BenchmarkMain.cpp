@@ -0,0 +1,42 @@
+#include <juce_audio_utils/juce_audio_utils.h>
+
+#include "BenchmarkRunner.h"
+#include "ApplicationPropertiesAndCommandManager.h"
+
+static ApplicationPropertiesAndCommandManager *applicationPropertiesAndCommandManager = nullptr;
+
+ApplicationProperties &getApplicationProperties() { return applicationPropertiesAndCommandManager->applicationProperties; }
+
+PropertiesFile *getUserSettings() { return getApplicationProperties().getUserSettings(); }
+
+ApplicationCommandManager &getCommandManager() { return applicationPropertiesAndCommandManager->commandManager; }
+
+// Usage: FlowGridBenchmarks [--output=benchmarks.json] [--filter=processor/*] [--min-seconds=0.2] [--min-iterations=5]
+int main(int argc, char *argv[]) {
+    const ScopedJuceInitialiser_GUI juceInitialiser;
+    ApplicationPropertiesAndCommandManager propertiesAndCommandManager;
+    applicationPropertiesAndCommandManager = &propertiesAndCommandManager;
+
+    const ArgumentList arguments(argc, argv);
+    BenchmarkRunner::Options options;
+    if (arguments.containsOption("--filter")) options.filter = arguments.getValueForOption("--filter");
+    if (arguments.containsOption("--min-seconds")) options.minSeconds = arguments.getValueForOption("--min-seconds").getDoubleValue();
+    if (arguments.containsOption("--min-iterations")) options.minIterations = arguments.getValueForOption("--min-iterations").getIntValue();
+    const auto outputFile = arguments.containsOption("--output") ? arguments.getFileForOption("--output")
+                                                                 : File::getCurrentWorkingDirectory().getChildFile("benchmarks.json");
+
+    BenchmarkRunner runner(options);
+    runProcessorBenchmarks(runner);
+    runProjectBenchmarks(runner);
+
+    int result = 0;
+    if (!outputFile.replaceWithText(JSON::toString(runner.toJson()))) {
+        std::cerr << "Could not write " << outputFile.getFullPathName() << std::endl;
+        result = 1;
+    } else {
+        std::cout << "Wrote " << runner.getNumResults() << " results to " << outputFile.getFullPathName() << std::endl;
+    }
+
+    applicationPropertiesAndCommandManager = nullptr;
+    return result;
+}
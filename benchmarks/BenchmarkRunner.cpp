@@ -0,0 +1,76 @@
+#include "BenchmarkRunner.h"
+
+#include "FlowGridConfig.h"
+
+String BenchmarkRunner::getFullName(const String &group, const String &name, const NamedValueSet &parameters) {
+    StringArray parameterStrings;
+    for (const auto &parameter : parameters)
+        parameterStrings.add(parameter.name.toString() + "=" + parameter.value.toString());
+    return group + "/" + name + (parameterStrings.isEmpty() ? "" : "/" + parameterStrings.joinIntoString(","));
+}
+
+void BenchmarkRunner::run(const String &group, const String &name, const NamedValueSet &parameters,
+                          const std::function<void()> &iteration, const std::function<void()> &setUp, int64 itemsPerIteration) {
+    const auto fullName = getFullName(group, name, parameters);
+    if (!isEnabled(fullName)) return;
+
+    for (int i = 0; i < options.warmupIterations; i++) {
+        if (setUp) setUp();
+        iteration();
+    }
+
+    std::vector<double> nanoseconds;
+    double totalSeconds = 0;
+    while ((totalSeconds < options.minSeconds || int(nanoseconds.size()) < options.minIterations) &&
+           int(nanoseconds.size()) < options.maxIterations) {
+        if (setUp) setUp();
+        const auto startTicks = Time::getHighResolutionTicks();
+        iteration();
+        const auto seconds = Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - startTicks);
+        nanoseconds.push_back(seconds * 1e9);
+        totalSeconds += seconds;
+    }
+
+    std::sort(nanoseconds.begin(), nanoseconds.end());
+    const auto numIterations = nanoseconds.size();
+    const auto percentile = [&](double p) { return nanoseconds[jmin(numIterations - 1, size_t(p * double(numIterations)))]; };
+    const double mean = totalSeconds * 1e9 / double(numIterations);
+
+    auto *result = new DynamicObject();
+    result->setProperty("name", fullName);
+    result->setProperty("group", group);
+    result->setProperty("benchmark", name);
+    auto *parametersObject = new DynamicObject();
+    for (const auto &parameter : parameters)
+        parametersObject->setProperty(parameter.name, parameter.value);
+    result->setProperty("parameters", var(parametersObject));
+    result->setProperty("iterations", int(numIterations));
+    result->setProperty("minNs", nanoseconds.front());
+    result->setProperty("medianNs", percentile(0.5));
+    result->setProperty("meanNs", mean);
+    result->setProperty("p90Ns", percentile(0.9));
+    result->setProperty("maxNs", nanoseconds.back());
+    if (itemsPerIteration > 0)
+        result->setProperty("medianNsPerItem", percentile(0.5) / double(itemsPerIteration));
+    results.add(var(result));
+
+    std::cout << fullName << ": median " << String(percentile(0.5) / 1000.0, 2) << "us, min " << String(nanoseconds.front() / 1000.0, 2)
+              << "us (" << numIterations << " iterations)" << std::endl;
+}
+
+var BenchmarkRunner::toJson() const {
+    auto *root = new DynamicObject();
+    root->setProperty("project", PROJECT_NAME);
+    root->setProperty("version", PROJECT_VERSION);
+#if JUCE_DEBUG
+    root->setProperty("buildType", "Debug");
+#else
+    root->setProperty("buildType", "Release");
+#endif
+    root->setProperty("timestamp", Time::getCurrentTime().toISO8601(true));
+    root->setProperty("os", SystemStats::getOperatingSystemName());
+    root->setProperty("cpu", SystemStats::getCpuModel());
+    root->setProperty("numCpus", SystemStats::getNumCpus());
+    root->setProperty("benchmarks", results);
+    return var(root);
+}
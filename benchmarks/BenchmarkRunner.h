@@ -0,0 +1,40 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+using namespace juce;
+
+/*!
+ *  Minimal micro-benchmark harness.
+ *  Each benchmark is warmed up, then timed one iteration at a time until it has run for at least `minSeconds`
+ *  and at least `minIterations` times. Results are collected as JSON, so runs of different versions can be diffed.
+ */
+struct BenchmarkRunner {
+    struct Options {
+        String filter{"*"}; // Wildcard pattern matched against full benchmark names
+        double minSeconds{0.2};
+        int minIterations{5};
+        int maxIterations{100000};
+        int warmupIterations{2};
+    };
+
+    explicit BenchmarkRunner(const Options &options) : options(options) {}
+
+    static String getFullName(const String &group, const String &name, const NamedValueSet &parameters);
+    bool isEnabled(const String &fullName) const { return fullName.matchesWildcard(options.filter, true); }
+
+    // Only `iteration` is timed. `setUp`, if given, is called before each iteration.
+    // `itemsPerIteration` (e.g. samples per block) adds a per-item time to the result.
+    void run(const String &group, const String &name, const NamedValueSet &parameters,
+             const std::function<void()> &iteration, const std::function<void()> &setUp = {}, int64 itemsPerIteration = 0);
+
+    int getNumResults() const { return results.size(); }
+    var toJson() const;
+
+private:
+    Options options;
+    Array<var> results;
+};
+
+void runProcessorBenchmarks(BenchmarkRunner &runner);
+void runProjectBenchmarks(BenchmarkRunner &runner);
@@ -0,0 +1,122 @@
+#include "BenchmarkRunner.h"
+
+#include "processors/Arpeggiator.h"
+#include "processors/BalanceProcessor.h"
+#include "processors/GainProcessor.h"
+#include "processors/MixerChannelProcessor.h"
+#include "processors/SineBank.h"
+#include "processors/SineSynth.h"
+#include "processors/TrackOutputProcessor.h"
+
+static constexpr double SAMPLE_RATE = 48000.0;
+static const int BLOCK_SIZES[] = {64, 256, 1024};
+static const int NUM_CHANNELS[] = {1, 2, 8};
+
+// Times `processBlock` on a buffer of noise, with a note on and off every block.
+// When `automated`, every parameter jumps to a new value before each block, so smoothed parameters are always ramping.
+template<typename ProcessorType>
+static void benchmarkProcessor(BenchmarkRunner &runner) {
+    for (const int blockSize : BLOCK_SIZES) {
+        for (const int numChannels : NUM_CHANNELS) {
+            for (const bool automated : {false, true}) {
+                NamedValueSet parameters;
+                parameters.set("blockSize", blockSize);
+                parameters.set("channels", numChannels);
+                parameters.set("automated", automated);
+                if (!runner.isEnabled(BenchmarkRunner::getFullName("processor", ProcessorType::name(), parameters))) continue;
+
+                ProcessorType processor;
+                processor.setRateAndBufferSizeDetails(SAMPLE_RATE, blockSize);
+                processor.prepareToPlay(SAMPLE_RATE, blockSize);
+
+                AudioBuffer<float> buffer(numChannels, blockSize);
+                MidiBuffer midi;
+                Random random(42);
+                int blockIndex = 0;
+                const auto setUp = [&] {
+                    for (int channel = 0; channel < numChannels; channel++) {
+                        auto *samples = buffer.getWritePointer(channel);
+                        for (int i = 0; i < blockSize; i++)
+                            samples[i] = random.nextFloat() * 2.0f - 1.0f;
+                    }
+                    midi.clear();
+                    midi.addEvent(MidiMessage::noteOn(1, 48 + blockIndex % 24, 0.8f), 0);
+                    midi.addEvent(MidiMessage::noteOff(1, 48 + (blockIndex + 20) % 24), blockSize / 2);
+                    if (automated)
+                        for (auto *parameter : processor.getParameters())
+                            parameter->setValueNotifyingHost(random.nextFloat());
+                    blockIndex++;
+                };
+
+                runner.run("processor", ProcessorType::name(), parameters, [&] { processor.processBlock(buffer, midi); }, setUp, blockSize);
+                processor.releaseResources();
+            }
+        }
+    }
+}
+
+// Times a `SineBank` with many partials, all gliding toward new frequencies and amplitudes on every block.
+static void benchmarkSineBankPartials(BenchmarkRunner &runner) {
+    for (const int blockSize : BLOCK_SIZES) {
+        for (const int numPartials : {16, 128, 512}) {
+            NamedValueSet parameters;
+            parameters.set("blockSize", blockSize);
+            parameters.set("partials", numPartials);
+            if (!runner.isEnabled(BenchmarkRunner::getFullName("processor", "Sine Bank partials", parameters))) continue;
+
+            SineBank processor(numPartials);
+            processor.setRateAndBufferSizeDetails(SAMPLE_RATE, blockSize);
+            processor.prepareToPlay(SAMPLE_RATE, blockSize);
+
+            AudioBuffer<float> buffer(2, blockSize);
+            MidiBuffer midi;
+            Random random(42);
+            const auto setUp = [&] {
+                for (auto *parameter : processor.getParameters())
+                    parameter->setValueNotifyingHost(random.nextFloat());
+            };
+
+            runner.run("processor", "Sine Bank partials", parameters, [&] { processor.processBlock(buffer, midi); }, setUp, blockSize);
+            processor.releaseResources();
+        }
+    }
+}
+
+// Times `LevelMeterSource::measureBlock` alone, on a buffer of noise, in each metering mode.
+static void benchmarkLevelMeterSource(BenchmarkRunner &runner) {
+    for (const int blockSize : BLOCK_SIZES) {
+        for (const int numChannels : NUM_CHANNELS) {
+            for (const auto mode : {LevelMeterSource::Mode::samplePeak, LevelMeterSource::Mode::loudness}) {
+                NamedValueSet parameters;
+                parameters.set("blockSize", blockSize);
+                parameters.set("channels", numChannels);
+                parameters.set("mode", mode == LevelMeterSource::Mode::loudness ? "loudness" : "samplePeak");
+                if (!runner.isEnabled(BenchmarkRunner::getFullName("meter", "LevelMeterSource", parameters))) continue;
+
+                LevelMeterSource meterSource;
+                meterSource.prepare(numChannels, SAMPLE_RATE, mode);
+                AudioBuffer<float> buffer(numChannels, blockSize);
+                Random random(42);
+                for (int channel = 0; channel < numChannels; channel++) {
+                    auto *samples = buffer.getWritePointer(channel);
+                    for (int i = 0; i < blockSize; i++)
+                        samples[i] = random.nextFloat() * 2.0f - 1.0f;
+                }
+
+                runner.run("meter", "LevelMeterSource", parameters, [&] { meterSource.measureBlock(buffer); }, {}, blockSize);
+            }
+        }
+    }
+}
+
+void runProcessorBenchmarks(BenchmarkRunner &runner) {
+    benchmarkProcessor<SineBank>(runner);
+    benchmarkProcessor<SineSynth>(runner);
+    benchmarkProcessor<MixerChannelProcessor>(runner);
+    benchmarkProcessor<TrackOutputProcessor>(runner);
+    benchmarkProcessor<BalanceProcessor>(runner);
+    benchmarkProcessor<GainProcessor>(runner);
+    benchmarkProcessor<Arpeggiator>(runner);
+    benchmarkSineBankPartials(runner);
+    benchmarkLevelMeterSource(runner);
+}
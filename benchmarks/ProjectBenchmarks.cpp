@@ -0,0 +1,138 @@
+#include "BenchmarkRunner.h"
+
+#include "model/Project.h"
+#include "action/Insert.h"
+#include "action/MoveSelectedItems.h"
+#include "action/UpdateAllDefaultConnections.h"
+#include "processors/BalanceProcessor.h"
+#include "processors/GainProcessor.h"
+#include "processors/SineBank.h"
+
+static const int NUM_PROCESSORS[] = {10, 100, 1000};
+
+// The same model the app builds, without any windows or audio devices.
+struct SyntheticProject {
+    SyntheticProject() : view(undoManager),
+                         tracks(view, undoManager, deviceManager),
+                         connections(tracks),
+                         input(pluginManager, undoManager, deviceManager),
+                         output(pluginManager, undoManager, deviceManager),
+                         allProcessors(tracks, connections, input, output),
+                         push2Colours(tracks),
+                         push2MidiCommunicator(view, push2Colours),
+                         processorGraph(allProcessors, pluginManager, tracks, connections, input, output, undoManager, deviceManager, push2MidiCommunicator),
+                         project(view, tracks, connections, input, output, allProcessors, processorGraph, undoManager, pluginManager, deviceManager) {
+        project.setHeadless(true);
+    }
+
+    ~SyntheticProject() {
+        project.clear();
+    }
+
+    // Starting from the default project, add tracks of `Sine Bank -> Gain -> Balance` until there are at least `numProcessors`.
+    void build(int numProcessors) {
+        project.newDocument();
+        while (getNumTrackProcessors() < numProcessors) {
+            project.createTrack(false);
+            project.createProcessor(SineBank::getPluginDescription());
+            project.createProcessor(GainProcessor::getPluginDescription());
+            project.createProcessor(BalanceProcessor::getPluginDescription());
+        }
+        processorGraph.flushPendingConnectionUpdates();
+        undoManager.clearUndoHistory();
+    }
+
+    int getNumTrackProcessors() const {
+        int numProcessors = 0;
+        for (const auto *track : tracks.getChildren())
+            numProcessors += track->getProcessorLane()->size();
+        return numProcessors;
+    }
+
+    Track *getFirstNonMasterTrack() const {
+        for (auto *track : tracks.getChildren())
+            if (!track->isMaster()) return track;
+        return nullptr;
+    }
+
+    PluginManager pluginManager;
+
+    UndoManager undoManager;
+    AudioDeviceManager deviceManager;
+
+    View view;
+    Tracks tracks;
+    Connections connections;
+    Input input;
+    Output output;
+    AllProcessors allProcessors;
+
+    Push2Colours push2Colours;
+    Push2MidiCommunicator push2MidiCommunicator;
+    ProcessorGraph processorGraph;
+    Project project;
+};
+
+void runProjectBenchmarks(BenchmarkRunner &runner) {
+    for (const int numProcessors : NUM_PROCESSORS) {
+        NamedValueSet parameters;
+        parameters.set("processors", numProcessors);
+
+        bool anyEnabled = false;
+        for (const auto *name : {"UpdateAllDefaultConnections", "MoveSelectedItems", "Insert", "loadDocument"})
+            anyEnabled |= runner.isEnabled(BenchmarkRunner::getFullName("project", name, parameters));
+        if (!anyEnabled) continue;
+
+        auto synthetic = std::make_unique<SyntheticProject>();
+        synthetic->build(numProcessors);
+        auto &project = synthetic->project;
+        auto &tracks = synthetic->tracks;
+        auto &connections = synthetic->connections;
+        auto &view = synthetic->view;
+        auto &input = synthetic->input;
+        auto &output = synthetic->output;
+        auto &allProcessors = synthetic->allProcessors;
+        auto &processorGraph = synthetic->processorGraph;
+
+        // Solve for the default connections of every track. They are already up-to-date, so this measures the solver itself.
+        runner.run("project", "UpdateAllDefaultConnections", parameters, [&] {
+            allProcessors.markAllDefaultConnectionsStale();
+            UpdateAllDefaultConnections(false, true, tracks, connections, input, output, allProcessors, processorGraph).perform();
+        });
+
+        // Drag the first track's generator one track to the right, and back.
+        auto *track = synthetic->getFirstNonMasterTrack();
+        const juce::Point<int> fromTrackAndSlot{track->getIndex(), 0}, toTrackAndSlot{track->getIndex() + 1, 0};
+        project.setProcessorSlotSelected(track, 0, true);
+        runner.run("project", "MoveSelectedItems", parameters, [&] {
+            MoveSelectedItems move(fromTrackAndSlot, toTrackAndSlot, false, tracks, connections, view, input, output, allProcessors, processorGraph);
+            move.perform();
+            processorGraph.flushPendingConnectionUpdates();
+            move.undo();
+            processorGraph.flushPendingConnectionUpdates();
+        });
+
+        // Paste a copy of the first track (creating its processors) and update default connections, as `Project::insert` does, then undo.
+        OwnedArray<Track> copiedTracks;
+        project.setTrackSelected(track, true);
+        tracks.copySelectedItemsInto(copiedTracks, processorGraph.getProcessorWrappers());
+        runner.run("project", "Insert", parameters, [&] {
+            Insert insert(false, copiedTracks, view.getFocusedTrackAndSlot(), tracks, connections, view, input, allProcessors, processorGraph);
+            insert.perform();
+            UpdateAllDefaultConnections updateConnections(false, true, tracks, connections, input, output, allProcessors, processorGraph);
+            updateConnections.perform();
+            processorGraph.flushPendingConnectionUpdates();
+            updateConnections.undo();
+            insert.undo();
+            processorGraph.flushPendingConnectionUpdates();
+        });
+
+        TemporaryFile projectFile(Project::getFilenameSuffix());
+        if (project.saveDocument(projectFile.getFile()).wasOk()) {
+            runner.run("project", "loadDocument", parameters, [&] {
+                project.loadDocument(projectFile.getFile());
+                processorGraph.flushPendingConnectionUpdates();
+            });
+        }
+    }
+}
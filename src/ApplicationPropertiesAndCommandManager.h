@@ -27,11 +27,13 @@ static const int
         navigateRight = 0x40002,
         navigateUp = 0x40003,
         navigateDown = 0x40004,
+        toggleDspProfiler = 0x40005,
         showPluginListEditor = 0x50000,
         showAudioMidiSettings = 0x50001,
         togglePaneFocus = 0x50002,
         aboutBox = 0x50003,
-        allWindowsForward = 0x50004;
+        allWindowsForward = 0x50004,
+        toggleParallelRendering = 0x50005;
 }
 
 class ApplicationPropertiesAndCommandManager {
@@ -0,0 +1,144 @@
+#include "AudioThreadChecker.h"
+
+#if JUCE_DEBUG
+
+#include "MpscQueue.h"
+
+namespace {
+struct ThreadState {
+    const AudioProcessor *processor;
+    int depth, allowDepth;
+    bool reporting;
+};
+
+// Constant-initialized, so the interceptors can use it from any thread at any time.
+thread_local ThreadState threadState{nullptr, 0, 0, false};
+
+struct Report {
+    const AudioProcessor *processor{nullptr};
+    AudioThreadChecker::Violation violation{AudioThreadChecker::Violation::allocation};
+};
+
+MpscQueue<Report, 1024> reports;
+std::atomic<int> numDroppedReports{0};
+
+const char *getViolationName(AudioThreadChecker::Violation violation) {
+    switch (violation) {
+        case AudioThreadChecker::Violation::allocation: return "Heap allocation";
+        case AudioThreadChecker::Violation::deallocation: return "Heap deallocation";
+        case AudioThreadChecker::Violation::blockingLock: return "Wait on a lock";
+        case AudioThreadChecker::Violation::syscall: return "Blocking syscall";
+    }
+    return "";
+}
+}
+
+AudioThreadChecker::Scope::Scope(const AudioProcessor *processor) noexcept : previousProcessor(threadState.processor) {
+    threadState.processor = processor;
+    threadState.depth++;
+}
+
+AudioThreadChecker::Scope::~Scope() noexcept {
+    threadState.depth--;
+    threadState.processor = previousProcessor;
+}
+
+AudioThreadChecker::ScopedAllow::ScopedAllow() noexcept { threadState.allowDepth++; }
+AudioThreadChecker::ScopedAllow::~ScopedAllow() noexcept { threadState.allowDepth--; }
+
+void AudioThreadChecker::report(Violation violation) noexcept {
+    auto &state = threadState;
+    if (state.depth == 0 || state.allowDepth > 0 || state.reporting) return;
+
+    state.reporting = true;
+    if (!reports.push({state.processor, violation}))
+        numDroppedReports.fetch_add(1, std::memory_order_relaxed);
+    state.reporting = false;
+}
+
+AudioThreadChecker::Reporter::Reporter(DescribeProcessor describeProcessor) : describeProcessor(std::move(describeProcessor)) {
+    startTimerHz(4);
+}
+
+AudioThreadChecker::Reporter::~Reporter() {
+    stopTimer();
+}
+
+void AudioThreadChecker::Reporter::timerCallback() {
+    Report report;
+    while (reports.pop(report)) {
+        // The same call usually happens every block. Only log it the first time.
+        if (reported.insert({report.processor, report.violation}).second)
+            DBG(getViolationName(report.violation) << " while rendering audio, in " << describeProcessor(report.processor));
+    }
+    if (const auto numDropped = numDroppedReports.exchange(0, std::memory_order_relaxed); numDropped > 0)
+        DBG("Dropped " << numDropped << " audio thread reports");
+}
+
+// The other replaceable forms (array, nothrow, sized) forward to these by default.
+// Aligned forms are left alone, since they're paired with their own deallocation function.
+void *operator new(std::size_t size) {
+    AudioThreadChecker::report(AudioThreadChecker::Violation::allocation);
+    if (auto *pointer = std::malloc(size == 0 ? 1 : size)) return pointer;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *pointer) noexcept {
+    if (pointer != nullptr) AudioThreadChecker::report(AudioThreadChecker::Violation::deallocation);
+    std::free(pointer);
+}
+
+#if JUCE_LINUX
+
+#include <dlfcn.h>
+#include <poll.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+
+// Interposes the libc function of the same name, forwarding to it.
+// Resolved lazily through a plain atomic, since a function-local static's guard could itself lock.
+#define FORWARD_TO_NEXT(name, ...) \
+    static std::atomic<decltype(&name)> next{nullptr}; \
+    auto *function = next.load(std::memory_order_relaxed); \
+    if (function == nullptr) next.store(function = reinterpret_cast<decltype(&name)>(dlsym(RTLD_NEXT, #name)), std::memory_order_relaxed); \
+    return function(__VA_ARGS__)
+
+extern "C" {
+// An uncontended lock never leaves user space, so only locks that have to wait are reported.
+int pthread_mutex_lock(pthread_mutex_t *mutex) noexcept {
+    if (threadState.depth > 0 && pthread_mutex_trylock(mutex) == 0) return 0;
+    if (threadState.depth > 0) AudioThreadChecker::report(AudioThreadChecker::Violation::blockingLock);
+    FORWARD_TO_NEXT(pthread_mutex_lock, mutex);
+}
+
+ssize_t read(int fd, void *buffer, size_t numBytes) {
+    AudioThreadChecker::report(AudioThreadChecker::Violation::syscall);
+    FORWARD_TO_NEXT(read, fd, buffer, numBytes);
+}
+
+ssize_t write(int fd, const void *buffer, size_t numBytes) {
+    AudioThreadChecker::report(AudioThreadChecker::Violation::syscall);
+    FORWARD_TO_NEXT(write, fd, buffer, numBytes);
+}
+
+int poll(struct pollfd *fds, nfds_t numFds, int timeout) {
+    AudioThreadChecker::report(AudioThreadChecker::Violation::syscall);
+    FORWARD_TO_NEXT(poll, fds, numFds, timeout);
+}
+
+int nanosleep(const struct timespec *duration, struct timespec *remaining) {
+    AudioThreadChecker::report(AudioThreadChecker::Violation::syscall);
+    FORWARD_TO_NEXT(nanosleep, duration, remaining);
+}
+
+int usleep(useconds_t micros) {
+    AudioThreadChecker::report(AudioThreadChecker::Violation::syscall);
+    FORWARD_TO_NEXT(usleep, micros);
+}
+}
+
+#undef FORWARD_TO_NEXT
+
+#endif
+#endif
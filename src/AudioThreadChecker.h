@@ -0,0 +1,73 @@
+#pragma once
+
+#include <set>
+
+#include <juce_audio_processors/juce_audio_processors.h>
+
+using namespace juce;
+
+/*!
+ *  Debug-build detector of real-time-unsafe calls made while rendering audio.
+ *
+ *  While a `Scope` is open on a thread, every heap allocation or deallocation (through the global `operator new`/`delete`),
+ *  and, on Linux, every lock that has to wait and every blocking file or sleep syscall, is reported along with
+ *  the processor of the innermost scope.
+ *  Reports are queued without locking or allocating, and a `Reporter` logs the first of each kind per processor
+ *  on the message thread.
+ *
+ *  In release builds, all of this compiles away.
+ */
+struct AudioThreadChecker {
+    enum class Violation { allocation, deallocation, blockingLock, syscall };
+
+#if JUCE_DEBUG
+    // Nest around each processor's `processBlock`. Scopes of the whole graph callback can pass the graph itself.
+    struct Scope {
+        explicit Scope(const AudioProcessor *processor) noexcept;
+        ~Scope() noexcept;
+
+        JUCE_DECLARE_NON_COPYABLE(Scope)
+
+    private:
+        const AudioProcessor *previousProcessor;
+    };
+
+    // For unsafe calls made on purpose (e.g. in debugging code).
+    struct ScopedAllow {
+        ScopedAllow() noexcept;
+        ~ScopedAllow() noexcept;
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedAllow)
+    };
+
+    // Called by the interceptors. Does nothing outside of a `Scope`.
+    static void report(Violation violation) noexcept;
+
+    // Describes a reported processor, which may have been deleted since.
+    using DescribeProcessor = std::function<String(const AudioProcessor *processor)>;
+
+    struct Reporter : private Timer {
+        explicit Reporter(DescribeProcessor describeProcessor);
+        ~Reporter() override;
+
+    private:
+        DescribeProcessor describeProcessor;
+        std::set<std::pair<const AudioProcessor *, Violation>> reported;
+
+        void timerCallback() override;
+    };
+#else
+    struct Scope {
+        explicit Scope(const AudioProcessor *) noexcept {}
+    };
+    struct ScopedAllow {
+        ScopedAllow() noexcept {}
+    };
+    static void report(Violation) noexcept {}
+
+    using DescribeProcessor = std::function<String(const AudioProcessor *processor)>;
+    struct Reporter {
+        explicit Reporter(DescribeProcessor) {}
+    };
+#endif
+};
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <map>
+
+#include <juce_gui_basics/juce_gui_basics.h>
+
+using namespace juce;
+
+/*!
+ *  Coalesces the relayouts and other derived updates that model listeners run in response to each change.
+ *
+ *  While a `Scope` is open, `callOrDefer` queues each named update once per component instead of running it,
+ *  and the outermost scope runs the queued updates, in the order they were first requested, when it closes.
+ *  Outside of a scope, updates run immediately.
+ *  Structural work (creating and removing the components that mirror the model) should still happen in the callback.
+ *
+ *  Message thread only.
+ */
+struct BatchedUpdates {
+    struct Scope {
+        Scope() {
+            JUCE_ASSERT_MESSAGE_THREAD
+            depth++;
+        }
+        ~Scope() {
+            if (--depth == 0) flush();
+        }
+
+        JUCE_DECLARE_NON_COPYABLE(Scope)
+    };
+
+    static void callOrDefer(Component &component, const Identifier &updateName, std::function<void()> update) {
+        JUCE_ASSERT_MESSAGE_THREAD
+        if (depth == 0) return update();
+
+        const Key key{&component, updateName.getCharPointer().getAddress()};
+        const auto existing = indexForKey.find(key);
+        if (existing == indexForKey.end()) {
+            indexForKey[key] = pending.size();
+            pending.push_back({&component, std::move(update)});
+        } else if (pending[existing->second].component == nullptr) {
+            // The component requesting it before was deleted, and this is a new one at the same address.
+            pending[existing->second] = {&component, std::move(update)};
+        }
+    }
+
+    static void resized(Component &component) {
+        static const Identifier resizedUpdate("resized");
+        callOrDefer(component, resizedUpdate, [&component] { component.resized(); });
+    }
+
+private:
+    using Key = std::pair<const Component *, const void *>;
+    struct PendingUpdate {
+        Component::SafePointer<Component> component;
+        std::function<void()> update;
+    };
+
+    inline static int depth = 0;
+    inline static std::vector<PendingUpdate> pending;
+    inline static std::map<Key, size_t> indexForKey;
+
+    static void flush() {
+        // Updates requested while flushing run immediately.
+        auto updates = std::move(pending);
+        pending.clear();
+        indexForKey.clear();
+        for (auto &[component, update] : updates)
+            if (component != nullptr) update();
+    }
+};
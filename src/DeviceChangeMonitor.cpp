@@ -0,0 +1,81 @@
+#include "DeviceChangeMonitor.h"
+
+#include "libusb.h"
+
+#if JUCE_MAC
+#include <CoreMIDI/CoreMIDI.h>
+
+static void onMidiNotification(const MIDINotification *notification, void *monitor) {
+    if (notification->messageID == kMIDIMsgSetupChanged)
+        static_cast<DeviceChangeMonitor *>(monitor)->deviceChangeReceived();
+}
+#endif
+
+static int LIBUSB_CALL onUsbHotplugEvent(libusb_context *, libusb_device *, libusb_hotplug_event, void *monitor) {
+    static_cast<DeviceChangeMonitor *>(monitor)->deviceChangeReceived();
+    return 0; // Stay registered
+}
+
+DeviceChangeMonitor::DeviceChangeMonitor(AudioDeviceManager &audioDeviceManager) : audioDeviceManager(audioDeviceManager) {
+    // Its own context, so it neither shares the default context's lifetime nor handles events meant for the usb communicators.
+    libusbInitialized = libusb_init(&usbContext) == LIBUSB_SUCCESS;
+    if (libusbInitialized && libusb_has_capability(LIBUSB_CAP_HAS_HOTPLUG)) {
+        usbHotplugSupported = libusb_hotplug_register_callback(
+                usbContext, static_cast<libusb_hotplug_event>(LIBUSB_HOTPLUG_EVENT_DEVICE_ARRIVED | LIBUSB_HOTPLUG_EVENT_DEVICE_LEFT),
+                static_cast<libusb_hotplug_flag>(0), LIBUSB_HOTPLUG_MATCH_ANY, LIBUSB_HOTPLUG_MATCH_ANY, LIBUSB_HOTPLUG_MATCH_ANY,
+                onUsbHotplugEvent, this, &hotplugCallbackHandle) == LIBUSB_SUCCESS;
+    }
+    if (usbHotplugSupported) {
+        usbEventThread = std::thread([this] {
+            struct timeval timeout_500ms = {0, 500000};
+            while (!terminate.load())
+                libusb_handle_events_timeout_completed(usbContext, &timeout_500ms, nullptr);
+        });
+    }
+#if JUCE_MAC
+    MIDIClientCreate(CFSTR("FlowGrid device monitor"), onMidiNotification, this, &midiClient);
+#endif
+
+    // Check the devices that are already connected.
+    deviceChangeReceived();
+}
+
+DeviceChangeMonitor::~DeviceChangeMonitor() {
+#if JUCE_MAC
+    if (midiClient != 0) MIDIClientDispose(midiClient);
+#endif
+    if (usbHotplugSupported) {
+        libusb_hotplug_deregister_callback(usbContext, hotplugCallbackHandle);
+        terminate.store(true);
+        libusb_interrupt_event_handler(usbContext);
+        usbEventThread.join();
+    }
+    if (libusbInitialized) libusb_exit(usbContext);
+    cancelPendingUpdate();
+}
+
+int DeviceChangeMonitor::getPollMillis() const {
+    if (!usbHotplugSupported) return POLL_MILLIS;
+#if JUCE_MAC
+    return 0;
+#else
+    return MIDI_POLL_MILLIS;
+#endif
+}
+
+void DeviceChangeMonitor::timerCallback() {
+    const bool checkUsbDevices = std::exchange(changeReceived, false) || !usbHotplugSupported;
+    const int pollMillis = getPollMillis();
+    if (pollMillis == 0) stopTimer();
+    else if (getTimerInterval() != pollMillis) startTimer(pollMillis);
+
+    if (checkUsbDevices && onUsbDevicesChanged != nullptr) onUsbDevicesChanged();
+
+    auto newMidiInputNames = MidiInput::getDevices();
+    auto newMidiOutputNames = MidiOutput::getDevices();
+    if (newMidiInputNames != midiInputNames || newMidiOutputNames != midiOutputNames) {
+        midiInputNames = std::move(newMidiInputNames);
+        midiOutputNames = std::move(newMidiOutputNames);
+        audioDeviceManager.sendChangeMessage();
+    }
+}
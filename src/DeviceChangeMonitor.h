@@ -1,23 +1,65 @@
 #pragma once
 
-class DeviceChangeMonitor : private Timer {
+#include <atomic>
+#include <functional>
+#include <thread>
+
+#include <juce_audio_devices/juce_audio_devices.h>
+
+struct libusb_context;
+
+using namespace juce;
+
+/*!
+ *  Watches for devices being connected or disconnected, without enumerating them periodically.
+ *
+ *  Usb devices are watched with libusb hotplug callbacks, handled on the monitor's own libusb event thread.
+ *  On macOS, CoreMIDI setup-change notifications are watched as well, to catch midi devices that aren't usb devices.
+ *  Connecting a device usually produces a burst of events, so they're debounced on the message thread.
+ *  Once they settle, `onUsbDevicesChanged` is called, and if the midi device lists changed,
+ *  the audio device manager sends a change message.
+ *
+ *  Where libusb has no hotplug support (e.g. on Windows), devices are checked every `POLL_MILLIS` instead.
+ *  Elsewhere without midi notifications (e.g. on Linux), the midi device lists alone are still checked every
+ *  `MIDI_POLL_MILLIS`, since not every midi port belongs to a usb device (e.g. virtual or bluetooth ports),
+ *  and a usb midi device's ports can show up well after the device itself.
+ */
+class DeviceChangeMonitor : private AsyncUpdater, private Timer {
 public:
-    explicit DeviceChangeMonitor(AudioDeviceManager &audioDeviceManager) : audioDeviceManager(audioDeviceManager) {
-        startTimer(1000);
-    }
+    explicit DeviceChangeMonitor(AudioDeviceManager &audioDeviceManager);
+
+    ~DeviceChangeMonitor() override;
+
+    // Called on the message thread, once after construction and then after every (debounced) device change.
+    std::function<void()> onUsbDevicesChanged;
+
+    // Notes that devices may have changed. Can be called from any thread.
+    void deviceChangeReceived() { triggerAsyncUpdate(); }
 
 private:
-    AudioDeviceManager &audioDeviceManager;
-    int numInputDevices{0}, numOutputDevices{0};
+    static constexpr int DEBOUNCE_MILLIS = 250, POLL_MILLIS = 1000, MIDI_POLL_MILLIS = 2000;
 
-    void timerCallback() override {
-        int newNumInputDevices = MidiInput::getDevices().size();
-        int newNumOutputDevices = MidiOutput::getDevices().size();
+    AudioDeviceManager &audioDeviceManager;
+    StringArray midiInputNames, midiOutputNames;
 
-        if (numInputDevices != newNumInputDevices || numOutputDevices != newNumOutputDevices)
-            audioDeviceManager.sendChangeMessage();
+    libusb_context *usbContext{};
+    bool libusbInitialized{false}, usbHotplugSupported{false};
+    int hotplugCallbackHandle{0};
+    std::thread usbEventThread;
+    std::atomic<bool> terminate{false};
+    // Message thread only. Set by events, so that polls in between them only check what's polled.
+    bool changeReceived{false};
+#if JUCE_MAC
+    uint32 midiClient{0};
+#endif
 
-        numInputDevices = newNumInputDevices;
-        numOutputDevices = newNumOutputDevices;
+    // Restarted by each event, so it only fires once they settle.
+    void handleAsyncUpdate() override {
+        changeReceived = true;
+        startTimer(DEBOUNCE_MILLIS);
     }
+
+    void timerCallback() override;
+    // The interval to check devices at between events, or 0 if events cover every device change.
+    int getPollMillis() const;
 };
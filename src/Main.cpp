@@ -8,6 +8,7 @@
 #include "ApplicationPropertiesAndCommandManager.h"
 #include "DeviceChangeMonitor.h"
 #include "FlowGridConfig.h"
+#include "OfflineRenderer.h"
 #include "action/DeleteProcessor.h"
 
 class FlowGridApplication : public JUCEApplication, public MenuBarModel, public ChangeListener {
@@ -17,7 +18,7 @@ public:
                             connections(tracks),
                             input(pluginManager, undoManager, deviceManager),
                             output(pluginManager, undoManager, deviceManager),
-                            allProcessors(tracks, input, output),
+                            allProcessors(tracks, connections, input, output),
                             push2Colours(tracks),
                             push2MidiCommunicator(view, push2Colours),
                             processorGraph(allProcessors, pluginManager, tracks, connections, input, output, undoManager, deviceManager, push2MidiCommunicator),
@@ -29,7 +30,15 @@ public:
 
     bool moreThanOneInstanceAllowed() override { return true; }
 
-    void initialise(const String &) override {
+    void initialise(const String &commandLine) override {
+        const ArgumentList arguments(getApplicationName(), commandLine);
+        if (arguments.containsOption("--render")) {
+            // Headless mode: render a project to a WAV file and exit, without any windows or audio devices.
+            setApplicationReturnValue(renderProjectHeadless(arguments));
+            quit();
+            return;
+        }
+
         Process::makeForegroundProcess();
 
         project.addChangeListener(this);
@@ -53,11 +62,18 @@ public:
 
         pluginListComponent = std::unique_ptr<PluginListComponent>(pluginManager.makePluginListComponent());
 
+        processorGraph.setParallelRenderingEnabled(getUserSettings()->getBoolValue("parallelRendering"));
+
         auto savedAudioState = getUserSettings()->getXmlValue("audioDeviceState");
         deviceManager.initialise(256, 256, savedAudioState.get(), true);
 
         deviceManager.addChangeListener(this);
 
+        // The monitor's first check comes after this, asynchronously.
+        deviceChangeMonitor->onUsbDevicesChanged = [this] {
+            if (push2Component != nullptr) push2Component->usbDevicesChanged();
+        };
+
         mainWindow = std::make_unique<MainWindow>(*this, "FlowGrid", new GraphEditor(view, tracks, connections, input, output, processorGraph, project, pluginManager));
         mainWindow->setBoundsRelative(0.02f, 0.02f, 0.96f, 0.96f);
 
@@ -77,9 +93,9 @@ public:
     }
 
     void shutdown() override {
+        deviceChangeMonitor = nullptr;
         push2Component = nullptr;
         push2Window = nullptr;
-        deviceChangeMonitor = nullptr;
         deviceManager.removeAudioCallback(&player);
         undoManager.removeChangeListener(this);
         project.removeChangeListener(this);
@@ -139,9 +155,11 @@ public:
             menu.addCommandItem(&getCommandManager(), CommandIDs::createMasterTrack);
         } else if (topLevelMenuIndex == 3) { // View menu
             menu.addCommandItem(&getCommandManager(), CommandIDs::showPush2MirrorWindow);
+            menu.addCommandItem(&getCommandManager(), CommandIDs::toggleDspProfiler);
         } else if (topLevelMenuIndex == 4) { // Options menu
             menu.addCommandItem(&getCommandManager(), CommandIDs::showAudioMidiSettings);
             menu.addCommandItem(&getCommandManager(), CommandIDs::showPluginListEditor);
+            menu.addCommandItem(&getCommandManager(), CommandIDs::toggleParallelRendering);
 
             const auto &pluginSortMethod = pluginManager.getPluginSortMethod();
 
@@ -208,9 +226,11 @@ public:
                 CommandIDs::navigateRight,
                 CommandIDs::navigateUp,
                 CommandIDs::navigateDown,
+                CommandIDs::toggleDspProfiler,
                 CommandIDs::showPluginListEditor,
                 CommandIDs::showAudioMidiSettings,
                 CommandIDs::togglePaneFocus,
+                CommandIDs::toggleParallelRendering,
 //                CommandIDs::aboutBox,
 //                CommandIDs::allWindowsForward,
         };
@@ -306,6 +326,17 @@ public:
                 result.addDefaultKeypress(KeyPress::downKey, ModifierKeys::noModifiers);
                 result.addDefaultKeypress(KeyPress::downKey, ModifierKeys::shiftModifier);
                 break;
+            case CommandIDs::toggleDspProfiler: {
+                String name = "Show DSP timing per processor";
+                if (processorGraph.isProfilingEnabled()) {
+                    const auto stats = processorGraph.getTimingStats().getSnapshot(processorGraph.getSampleRate());
+                    name << " (graph: " << String(stats.meanMicros, 1) << " us mean, "
+                         << String(stats.p99Micros, 1) << " us p99, " << String(stats.budgetShare * 100.0, 1) << "% of budget)";
+                }
+                result.setInfo(name, String(), category, 0);
+                result.setTicked(processorGraph.isProfilingEnabled());
+                break;
+            }
             case CommandIDs::showPluginListEditor:
                 result.setInfo("Edit the list of available plugins", String(), category, 0);
                 result.addDefaultKeypress('p', ModifierKeys::commandModifier);
@@ -318,6 +349,10 @@ public:
                 result.setInfo("Change the focused pane", String(), category, 0);
                 result.addDefaultKeypress(KeyPress::tabKey, ModifierKeys::noModifiers);
                 break;
+            case CommandIDs::toggleParallelRendering:
+                result.setInfo("Render independent tracks on multiple cores", String(), category, 0);
+                result.setTicked(processorGraph.isParallelRenderingEnabled());
+                break;
 //            case CommandIDs::aboutBox:
 //                result.setInfo ("About...", String(), category, 0);
 //                break;
@@ -377,6 +412,9 @@ public:
             case CommandIDs::showPush2MirrorWindow:
                 showPush2MirrorWindow();
                 break;
+            case CommandIDs::toggleDspProfiler:
+                processorGraph.setProfilingEnabled(!processorGraph.isProfilingEnabled());
+                break;
             case CommandIDs::navigateLeft:
                 project.navigateLeft();
                 break;
@@ -398,6 +436,10 @@ public:
             case CommandIDs::togglePaneFocus:
                 view.togglePaneFocus();
                 break;
+            case CommandIDs::toggleParallelRendering:
+                processorGraph.setParallelRenderingEnabled(!processorGraph.isParallelRenderingEnabled());
+                getUserSettings()->setValue("parallelRendering", processorGraph.isParallelRenderingEnabled());
+                break;
 //            case CommandIDs::aboutBox:
 //                // TODO
 //                break;
@@ -528,6 +570,47 @@ private:
     std::unique_ptr<DocumentWindow> push2Window;
     std::unique_ptr<PluginListComponent> pluginListComponent;
 
+    // Usage: FlowGrid --render=project.smp --output=render.wav [--seconds=10] [--block-size=512] [--sample-rate=44100] [--channels=2] [--parallel]
+    int renderProjectHeadless(const ArgumentList &arguments) {
+        const auto projectFile = arguments.getFileForOption("--render");
+        if (!projectFile.existsAsFile()) {
+            std::cerr << "Project file not found: " << projectFile.getFullPathName() << std::endl;
+            return 1;
+        }
+        const auto outputFile = arguments.containsOption("--output") ? arguments.getFileForOption("--output") : projectFile.withFileExtension(".wav");
+
+        OfflineRenderer::Options options;
+        if (arguments.containsOption("--seconds")) options.lengthSeconds = arguments.getValueForOption("--seconds").getDoubleValue();
+        if (arguments.containsOption("--block-size")) options.blockSize = arguments.getValueForOption("--block-size").getIntValue();
+        if (arguments.containsOption("--sample-rate")) options.sampleRate = arguments.getValueForOption("--sample-rate").getDoubleValue();
+        if (arguments.containsOption("--channels")) options.numOutputChannels = arguments.getValueForOption("--channels").getIntValue();
+
+        processorGraph.setParallelRenderingEnabled(arguments.containsOption("--parallel"));
+        OfflineRenderer renderer(processorGraph, options);
+        renderer.prepare();
+        project.setHeadless(true);
+        // Load the document directly (rather than `loadFrom`) so the recent-projects list isn't touched.
+        auto result = project.loadDocument(projectFile);
+        if (result.failed()) {
+            std::cerr << "Could not load " << projectFile.getFullPathName() << ": " << result.getErrorMessage() << std::endl;
+            return 1;
+        }
+
+        const auto startTime = Time::getMillisecondCounterHiRes();
+        result = renderer.renderTo(outputFile);
+        const auto elapsedSeconds = (Time::getMillisecondCounterHiRes() - startTime) / 1000.0;
+        project.clear();
+        if (result.failed()) {
+            std::cerr << "Render failed: " << result.getErrorMessage() << std::endl;
+            return 1;
+        }
+
+        const auto renderedSeconds = double(renderer.getNumSamplesRendered()) / options.sampleRate;
+        std::cout << "Rendered " << renderedSeconds << "s of audio to " << outputFile.getFullPathName()
+                  << " in " << elapsedSeconds << "s (" << (elapsedSeconds > 0 ? renderedSeconds / elapsedSeconds : 0.0) << "x realtime)" << std::endl;
+        return 0;
+    }
+
     void showAudioMidiSettings() {
         auto *audioSettingsComponent = new AudioDeviceSelectorComponent(deviceManager, 2, 256, 2, 256, true, true, true, false);
         audioSettingsComponent->setSize(500, 450);
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <atomic>
+#include <array>
+#include <cstdint>
+
+/*!
+ *  Bounded lock-free multi-producer, single-consumer queue (Dmitry Vyukov's bounded MPMC queue, with a plain consumer index).
+ *  `push` can be called from any thread. `pop` must only be called from one thread at a time.
+ *  Neither ever blocks or allocates.
+ */
+template<typename T, size_t Capacity>
+struct MpscQueue {
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+    MpscQueue() {
+        for (size_t i = 0; i < Capacity; i++)
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    // Returns `false` if the queue is full.
+    bool push(const T &item) noexcept {
+        auto position = enqueuePosition.load(std::memory_order_relaxed);
+        while (true) {
+            auto &cell = cells[position & MASK];
+            const auto sequence = cell.sequence.load(std::memory_order_acquire);
+            const auto difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+            if (difference == 0) {
+                if (enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    cell.item = item;
+                    cell.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (difference < 0) {
+                return false;
+            } else {
+                position = enqueuePosition.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Returns `false` if the queue is empty.
+    bool pop(T &item) noexcept {
+        auto &cell = cells[dequeuePosition & MASK];
+        const auto sequence = cell.sequence.load(std::memory_order_acquire);
+        if (static_cast<intptr_t>(sequence) - static_cast<intptr_t>(dequeuePosition + 1) < 0) return false;
+
+        item = cell.item;
+        cell.sequence.store(dequeuePosition + Capacity, std::memory_order_release);
+        dequeuePosition++;
+        return true;
+    }
+
+    // Only call from the consuming thread. Approximate while other threads are pushing.
+    size_t size() const noexcept {
+        return enqueuePosition.load(std::memory_order_relaxed) - dequeuePosition;
+    }
+
+private:
+    static constexpr size_t MASK = Capacity - 1;
+
+    struct Cell {
+        std::atomic<size_t> sequence{0};
+        T item{};
+    };
+
+    std::array<Cell, Capacity> cells;
+    std::atomic<size_t> enqueuePosition{0};
+    size_t dequeuePosition{0};
+};
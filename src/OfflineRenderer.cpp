@@ -0,0 +1,52 @@
+#include "OfflineRenderer.h"
+
+void OfflineRenderer::prepare() {
+    processorGraph.setNonRealtime(true);
+    processorGraph.setPlayConfigDetails(0, options.numOutputChannels, options.sampleRate, options.blockSize);
+}
+
+Result OfflineRenderer::renderTo(const File &outputFile) {
+    if (options.blockSize <= 0 || options.sampleRate <= 0 || options.numOutputChannels <= 0)
+        return Result::fail(TRANS("Invalid render options"));
+
+    outputFile.deleteFile();
+    auto outputStream = outputFile.createOutputStream();
+    if (outputStream == nullptr)
+        return Result::fail(TRANS("Could not open \"") + outputFile.getFullPathName() + TRANS("\" for writing"));
+
+    WavAudioFormat wavFormat;
+    std::unique_ptr<AudioFormatWriter> writer(wavFormat.createWriterFor(outputStream.get(), options.sampleRate,
+                                                                        static_cast<unsigned int>(options.numOutputChannels),
+                                                                        options.bitsPerSample, {}, 0));
+    if (writer == nullptr)
+        return Result::fail(TRANS("Could not create a WAV writer with the requested format"));
+    outputStream.release(); // The writer owns the stream now
+
+    // On the message thread, this rebuilds the render sequence synchronously,
+    // so the first `processBlock` call already sees the whole loaded graph.
+    processorGraph.prepareToPlay(options.sampleRate, options.blockSize);
+
+    const int numBufferChannels = jmax(processorGraph.getTotalNumInputChannels(), processorGraph.getTotalNumOutputChannels());
+    AudioBuffer<float> buffer(numBufferChannels, options.blockSize);
+    MidiBuffer midiMessages;
+
+    const auto numSamplesToRender = static_cast<int64>(options.lengthSeconds * options.sampleRate);
+    numSamplesRendered = 0;
+    while (numSamplesRendered < numSamplesToRender) {
+        const auto numSamples = static_cast<int>(jmin(static_cast<int64>(options.blockSize), numSamplesToRender - numSamplesRendered));
+        buffer.setSize(numBufferChannels, numSamples, false, false, true);
+        buffer.clear();
+        midiMessages.clear();
+
+        processorGraph.processBlock(buffer, midiMessages);
+
+        if (!writer->writeFromAudioSampleBuffer(buffer, 0, numSamples)) {
+            processorGraph.releaseResources();
+            return Result::fail(TRANS("Could not write to \"") + outputFile.getFullPathName() + "\"");
+        }
+        numSamplesRendered += numSamples;
+    }
+
+    processorGraph.releaseResources();
+    return Result::ok();
+}
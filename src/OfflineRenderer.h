@@ -0,0 +1,35 @@
+#pragma once
+
+#include <juce_audio_formats/juce_audio_formats.h>
+
+#include "ProcessorGraph.h"
+
+/*!
+ *  Pulls blocks through a `ProcessorGraph` in a tight loop and writes them to a WAV file.
+ *  No audio device or window is involved, so this runs as fast as the graph can be processed.
+ */
+struct OfflineRenderer {
+    struct Options {
+        double sampleRate{44100.0};
+        int blockSize{512};
+        int numOutputChannels{2};
+        double lengthSeconds{10.0};
+        int bitsPerSample{24};
+    };
+
+    OfflineRenderer(ProcessorGraph &processorGraph, const Options &options) : processorGraph(processorGraph), options(options) {}
+
+    // Call this _before_ loading the project to render, so that the IO processors
+    // are created with the render channel layout and sample rate instead of the (absent) device's.
+    void prepare();
+
+    Result renderTo(const File &outputFile);
+
+    const Options &getOptions() const { return options; }
+    int64 getNumSamplesRendered() const { return numSamplesRendered; }
+
+private:
+    ProcessorGraph &processorGraph;
+    Options options;
+    int64 numSamplesRendered{0};
+};
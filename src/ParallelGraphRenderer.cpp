@@ -0,0 +1,305 @@
+#include <thread>
+
+#include "ParallelGraphRenderer.h"
+#include "AudioThreadChecker.h"
+
+static constexpr int MAX_CHAINS = 0xffff;
+static constexpr int MIDI_BUFFER_SIZE = 4096;
+
+static uint64 packChainClaim(uint32 generation, int index, int numChains) {
+    return (uint64(generation) << 32) | (uint64(index) << 16) | uint64(numChains);
+}
+static int getClaimIndex(uint64 claim) { return int((claim >> 16) & 0xffff); }
+static int getClaimNumChains(uint64 claim) { return int(claim & 0xffff); }
+
+ParallelGraphRenderer::ParallelGraphRenderer(AudioProcessorGraph &graph, StageForNode stageForNode)
+        : graph(graph), stageForNode(std::move(stageForNode)) {
+    graph.addChangeListener(this);
+}
+
+ParallelGraphRenderer::~ParallelGraphRenderer() {
+    graph.removeChangeListener(this);
+    cancelPendingUpdate();
+    setEnabled(false);
+}
+
+void ParallelGraphRenderer::setEnabled(bool enabled) {
+    if (this->enabled == enabled) return;
+
+    this->enabled = enabled;
+    if (enabled) {
+        rebuild();
+    } else {
+        clear();
+        resizeWorkers(0);
+    }
+}
+
+void ParallelGraphRenderer::resizeWorkers(int numWorkers) {
+    while (workers.size() < numWorkers)
+        workers.add(new Worker(*this, workers.size()))->startThread(Thread::realtimeAudioPriority);
+    if (workers.size() <= numWorkers) return;
+
+    for (int i = numWorkers; i < workers.size(); i++)
+        workers.getUnchecked(i)->signalThreadShouldExit();
+    wakeWorkers();
+    workers.removeRange(numWorkers, workers.size() - numWorkers);
+}
+
+void ParallelGraphRenderer::wakeWorkers() {
+    wakeUps.fetch_add(1, std::memory_order_release);
+    wakeUps.notify_all();
+}
+
+bool ParallelGraphRenderer::hasUnclaimedChains() const {
+    const auto claim = chainClaim.load();
+    return getClaimIndex(claim) < getClaimNumChains(claim);
+}
+
+void ParallelGraphRenderer::clear() {
+    std::unique_ptr<Schedule> oldSchedule;
+    {
+        const SpinLock::ScopedLockType lock(scheduleLock);
+        std::swap(schedule, oldSchedule);
+    }
+    // Destroyed outside the lock. Any nodes only the old schedule was holding on to are released here, on this thread.
+}
+
+void ParallelGraphRenderer::rebuild() {
+    if (!enabled) return;
+
+    auto newSchedule = std::make_unique<Schedule>();
+    if (!buildSchedule(*newSchedule)) newSchedule = nullptr;
+    const int numChains = newSchedule != nullptr ? int(newSchedule->chains.size()) : 0;
+    {
+        const SpinLock::ScopedLockType lock(scheduleLock);
+        std::swap(schedule, newSchedule);
+    }
+    // No more workers than chains that can render alongside the audio thread's, or spare cpus to run them.
+    resizeWorkers(jlimit(0, jmax(0, SystemStats::getNumCpus() - 1), numChains - 1));
+}
+
+bool ParallelGraphRenderer::buildSchedule(Schedule &newSchedule) const {
+    newSchedule.blockSize = graph.getBlockSize();
+    if (newSchedule.blockSize <= 0) return false;
+
+    const auto &nodes = graph.getNodes();
+    const auto connections = graph.getConnections();
+
+    std::unordered_map<uint32, int> nodeIndexForId;
+    for (int i = 0; i < nodes.size(); i++)
+        nodeIndexForId[nodes.getUnchecked(i)->nodeID.uid] = i;
+
+    // Kahn's algorithm
+    std::vector<int> numIncoming(size_t(nodes.size()), 0);
+    std::vector<std::vector<int>> destinations(size_t(nodes.size()));
+    for (const auto &connection : connections) {
+        const auto sourceIt = nodeIndexForId.find(connection.source.nodeID.uid);
+        const auto destIt = nodeIndexForId.find(connection.destination.nodeID.uid);
+        if (sourceIt == nodeIndexForId.end() || destIt == nodeIndexForId.end()) return false;
+        destinations[size_t(sourceIt->second)].push_back(destIt->second);
+        numIncoming[size_t(destIt->second)]++;
+    }
+    std::vector<int> order;
+    order.reserve(size_t(nodes.size()));
+    for (int i = 0; i < nodes.size(); i++)
+        if (numIncoming[size_t(i)] == 0) order.push_back(i);
+    for (size_t i = 0; i < order.size(); i++)
+        for (int destination : destinations[size_t(order[i])])
+            if (--numIncoming[size_t(destination)] == 0) order.push_back(destination);
+    if (order.size() != size_t(nodes.size())) return false; // Cycle
+
+    std::unordered_map<uint32, int> taskIndexForId;
+    std::vector<int> stageForTask;
+    newSchedule.tasks.resize(order.size());
+    for (size_t taskIndex = 0; taskIndex < order.size(); taskIndex++) {
+        auto &task = newSchedule.tasks[taskIndex];
+        task.node = nodes.getUnchecked(order[taskIndex]);
+        auto *processor = task.node->getProcessor();
+        if (processor->getLatencySamples() > 0) return false;
+
+        int stage = stageForNode(task.node->nodeID);
+        if (auto *ioProcessor = dynamic_cast<AudioProcessorGraph::AudioGraphIOProcessor *>(processor)) {
+            switch (ioProcessor->getType()) {
+                case AudioProcessorGraph::AudioGraphIOProcessor::audioInputNode: task.kind = NodeTask::Kind::audioInput; break;
+                case AudioProcessorGraph::AudioGraphIOProcessor::audioOutputNode: task.kind = NodeTask::Kind::audioOutput; break;
+                case AudioProcessorGraph::AudioGraphIOProcessor::midiInputNode: task.kind = NodeTask::Kind::midiInput; break;
+                case AudioProcessorGraph::AudioGraphIOProcessor::midiOutputNode: task.kind = NodeTask::Kind::midiOutput; break;
+                default: break;
+            }
+            // Graph IO is only ever touched on the audio thread.
+            const bool isInput = task.kind == NodeTask::Kind::audioInput || task.kind == NodeTask::Kind::midiInput;
+            stage = isInput ? PRE_STAGE : POST_STAGE;
+        }
+        stageForTask.push_back(stage);
+        taskIndexForId[task.node->nodeID.uid] = int(taskIndex);
+
+        task.buffer.setSize(jmax(processor->getTotalNumInputChannels(), processor->getTotalNumOutputChannels()), newSchedule.blockSize);
+        task.midi.ensureSize(MIDI_BUFFER_SIZE);
+    }
+
+    // Chains joined by a connection are merged (union-find over the track indices).
+    std::map<int, int> parentChain;
+    const std::function<int(int)> findChain = [&](int chain) {
+        auto it = parentChain.find(chain);
+        if (it == parentChain.end()) return parentChain[chain] = chain;
+        return it->second == chain ? chain : (it->second = findChain(it->second));
+    };
+    const auto getStageRank = [](int stage) { return stage == PRE_STAGE ? 0 : stage == POST_STAGE ? 2 : 1; };
+    for (const auto &connection : connections) {
+        const int sourceTask = taskIndexForId[connection.source.nodeID.uid];
+        const int destTask = taskIndexForId[connection.destination.nodeID.uid];
+        const int sourceStage = stageForTask[size_t(sourceTask)], destStage = stageForTask[size_t(destTask)];
+        if (getStageRank(sourceStage) > getStageRank(destStage)) return false;
+        if (getStageRank(sourceStage) == 1 && getStageRank(destStage) == 1)
+            parentChain[findChain(sourceStage)] = findChain(destStage);
+
+        auto &dest = newSchedule.tasks[size_t(destTask)];
+        if (connection.source.isMIDI()) {
+            if (std::find(dest.midiInputs.begin(), dest.midiInputs.end(), sourceTask) == dest.midiInputs.end())
+                dest.midiInputs.push_back(sourceTask);
+        } else if (connection.source.channelIndex < newSchedule.tasks[size_t(sourceTask)].buffer.getNumChannels() &&
+                   connection.destination.channelIndex < dest.buffer.getNumChannels()) {
+            dest.audioInputs.push_back({sourceTask, connection.source.channelIndex, connection.destination.channelIndex});
+        }
+    }
+
+    std::map<int, size_t> chainIndexForRoot;
+    for (size_t taskIndex = 0; taskIndex < newSchedule.tasks.size(); taskIndex++) {
+        const int stage = stageForTask[taskIndex];
+        if (stage == PRE_STAGE) {
+            newSchedule.preTasks.push_back(int(taskIndex));
+        } else if (stage == POST_STAGE) {
+            newSchedule.postTasks.push_back(int(taskIndex));
+        } else {
+            const auto [it, inserted] = chainIndexForRoot.emplace(findChain(stage), newSchedule.chains.size());
+            if (inserted) newSchedule.chains.emplace_back();
+            newSchedule.chains[it->second].push_back(int(taskIndex));
+        }
+    }
+    if (newSchedule.chains.size() < 2 || newSchedule.chains.size() > size_t(MAX_CHAINS)) return false;
+
+    newSchedule.outputBuffer.setSize(graph.getTotalNumOutputChannels(), newSchedule.blockSize);
+    newSchedule.outputMidi.ensureSize(MIDI_BUFFER_SIZE);
+    return true;
+}
+
+bool ParallelGraphRenderer::process(AudioBuffer<float> &buffer, MidiBuffer &midiMessages) {
+    if (!enabled.load(std::memory_order_relaxed)) return false;
+
+    const SpinLock::ScopedTryLockType lock(scheduleLock);
+    if (!lock.isLocked() || schedule == nullptr) return false;
+
+    const int numSamples = buffer.getNumSamples();
+    if (numSamples > schedule->blockSize) return false;
+
+    schedule->outputBuffer.setSize(schedule->outputBuffer.getNumChannels(), numSamples, false, false, true);
+    schedule->outputBuffer.clear();
+    schedule->outputMidi.clear();
+    graphInputBuffer = &buffer;
+    graphInputMidi = &midiMessages;
+
+    for (int taskIndex : schedule->preTasks)
+        renderTask(*schedule, schedule->tasks[size_t(taskIndex)], numSamples);
+
+    activeSchedule = schedule.get();
+    activeNumSamples = numSamples;
+    const auto numChains = int(schedule->chains.size());
+    chainsRemaining.store(numChains, std::memory_order_relaxed);
+    // Sequentially consistent with the workers' check before sleeping, so either they see this block or it sees them asleep.
+    chainClaim.store(packChainClaim(++generation, 0, numChains));
+    if (numSleeping.load() > 0) wakeWorkers();
+
+    renderChains();
+    while (chainsRemaining.load(std::memory_order_acquire) > 0)
+        std::this_thread::yield();
+    activeSchedule = nullptr;
+
+    for (int taskIndex : schedule->postTasks)
+        renderTask(*schedule, schedule->tasks[size_t(taskIndex)], numSamples);
+
+    const int numOutputChannels = schedule->outputBuffer.getNumChannels();
+    for (int channel = 0; channel < buffer.getNumChannels(); channel++) {
+        if (channel < numOutputChannels)
+            buffer.copyFrom(channel, 0, schedule->outputBuffer, channel, 0, numSamples);
+        else
+            buffer.clear(channel, 0, numSamples);
+    }
+    midiMessages.clear();
+    midiMessages.addEvents(schedule->outputMidi, 0, numSamples, 0);
+    return true;
+}
+
+bool ParallelGraphRenderer::renderChains() {
+    const AudioThreadChecker::Scope checkerScope(&graph);
+    bool renderedAny = false;
+    auto claim = chainClaim.load(std::memory_order_acquire);
+    while (getClaimIndex(claim) < getClaimNumChains(claim)) {
+        if (!chainClaim.compare_exchange_weak(claim, claim + (uint64(1) << 16), std::memory_order_acq_rel, std::memory_order_acquire))
+            continue;
+
+        // The block can't finish before this chain does, so the active schedule stays valid until then.
+        for (int taskIndex : activeSchedule->chains[size_t(getClaimIndex(claim))])
+            renderTask(*activeSchedule, activeSchedule->tasks[size_t(taskIndex)], activeNumSamples);
+        chainsRemaining.fetch_sub(1, std::memory_order_release);
+        renderedAny = true;
+        claim = chainClaim.load(std::memory_order_acquire);
+    }
+    return renderedAny;
+}
+
+void ParallelGraphRenderer::renderTask(Schedule &schedule, NodeTask &task, int numSamples) {
+    auto &buffer = task.buffer;
+    buffer.setSize(buffer.getNumChannels(), numSamples, false, false, true);
+    buffer.clear();
+    task.midi.clear();
+
+    for (const auto &input : task.audioInputs)
+        buffer.addFrom(input.destChannel, 0, schedule.tasks[size_t(input.sourceTask)].buffer, input.sourceChannel, 0, numSamples);
+    for (int sourceTask : task.midiInputs)
+        task.midi.addEvents(schedule.tasks[size_t(sourceTask)].midi, 0, numSamples, 0);
+
+    switch (task.kind) {
+        case NodeTask::Kind::audioInput:
+            for (int channel = 0; channel < jmin(buffer.getNumChannels(), graphInputBuffer->getNumChannels()); channel++)
+                buffer.copyFrom(channel, 0, *graphInputBuffer, channel, 0, numSamples);
+            return;
+        case NodeTask::Kind::midiInput:
+            task.midi.addEvents(*graphInputMidi, 0, numSamples, 0);
+            return;
+        case NodeTask::Kind::audioOutput:
+            for (int channel = 0; channel < jmin(buffer.getNumChannels(), schedule.outputBuffer.getNumChannels()); channel++)
+                schedule.outputBuffer.addFrom(channel, 0, buffer, channel, 0, numSamples);
+            return;
+        case NodeTask::Kind::midiOutput:
+            schedule.outputMidi.addEvents(task.midi, 0, numSamples, 0);
+            return;
+        case NodeTask::Kind::processor:
+            break;
+    }
+
+    auto *processor = task.node->getProcessor();
+    const AudioThreadChecker::Scope checkerScope(processor);
+    const ScopedLock callbackLock(processor->getCallbackLock());
+    if (processor->isSuspended())
+        buffer.clear();
+    else if (task.node->isBypassed())
+        processor->processBlockBypassed(buffer, task.midi);
+    else
+        processor->processBlock(buffer, task.midi);
+}
+
+void ParallelGraphRenderer::Worker::run() {
+    ScopedNoDenormals noDenormals;
+    while (!threadShouldExit()) {
+        if (renderer.renderChains()) continue;
+
+        // Every chain of the current block is claimed. Sleep until the audio thread starts the next block, rather than
+        // spinning through the rest of the block period. A wake-up since `wakeUpsSeen` was read returns at once.
+        const auto wakeUpsSeen = renderer.wakeUps.load(std::memory_order_acquire);
+        renderer.numSleeping.fetch_add(1);
+        if (!threadShouldExit() && !renderer.hasUnclaimedChains())
+            renderer.wakeUps.wait(wakeUpsSeen, std::memory_order_acquire);
+        renderer.numSleeping.fetch_sub(1);
+    }
+}
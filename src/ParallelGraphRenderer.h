@@ -0,0 +1,115 @@
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+
+using namespace juce;
+
+/*!
+ *  Renders an `AudioProcessorGraph` on the audio thread plus a pool of worker threads.
+ *
+ *  Nodes are split into three stages, rendered in order:
+ *   * _pre_: sources shared by many tracks (the `Input` processors), on the audio thread,
+ *   * _chains_: one per non-master track (merged wherever custom connections join tracks),
+ *     claimed lock-free by the audio thread and the workers and rendered concurrently,
+ *   * _post_: the master track and the `Output` processors summing the chains, on the audio thread.
+ *
+ *  When the graph can't be split this way (a connection runs back up the stages, there are fewer than two chains,
+ *  or a node reports latency, which this renderer doesn't compensate for), `process` returns `false`,
+ *  and the caller should fall back to the graph's own serial rendering.
+ */
+class ParallelGraphRenderer : private ChangeListener, private AsyncUpdater {
+public:
+    // Chain nodes map to their (non-master) track index.
+    static constexpr int PRE_STAGE = -1, POST_STAGE = -2;
+    using StageForNode = std::function<int(AudioProcessorGraph::NodeID)>;
+
+    ParallelGraphRenderer(AudioProcessorGraph &graph, StageForNode stageForNode);
+    ~ParallelGraphRenderer() override;
+
+    void setEnabled(bool enabled);
+    bool isEnabled() const { return enabled; }
+    // One less than the number of chains that can render at once (the audio thread renders one), at most one per spare cpu.
+    int getNumWorkers() const { return workers.size(); }
+
+    // Rebuild the schedule from the graph's current nodes and connections. Call after the graph is prepared.
+    void rebuild();
+    void clear();
+    // Call right after changing the graph's nodes or connections, or preparing it off the message thread.
+    // The stale schedule is dropped at once, so the graph renders serially until the rebuild (on the message thread) lands.
+    void graphChanged() {
+        clear();
+        triggerAsyncUpdate();
+    }
+
+    // Called on the audio thread. Returns `false` if the block was not rendered.
+    bool process(AudioBuffer<float> &buffer, MidiBuffer &midiMessages);
+
+private:
+    struct NodeTask {
+        enum class Kind { processor, audioInput, audioOutput, midiInput, midiOutput };
+        struct AudioInput { int sourceTask, sourceChannel, destChannel; };
+
+        AudioProcessorGraph::Node::Ptr node;
+        Kind kind{Kind::processor};
+        AudioBuffer<float> buffer;
+        MidiBuffer midi;
+        std::vector<AudioInput> audioInputs;
+        std::vector<int> midiInputs;
+    };
+
+    struct Schedule {
+        std::vector<NodeTask> tasks; // In topological order
+        std::vector<int> preTasks, postTasks;
+        std::vector<std::vector<int>> chains;
+        AudioBuffer<float> outputBuffer;
+        MidiBuffer outputMidi;
+        int blockSize{0};
+    };
+
+    struct Worker : public Thread {
+        Worker(ParallelGraphRenderer &renderer, int index) : Thread("Graph render worker " + String(index)), renderer(renderer) {}
+        ~Worker() override { stopThread(1000); }
+
+        void run() override;
+
+    private:
+        ParallelGraphRenderer &renderer;
+    };
+
+    AudioProcessorGraph &graph;
+    StageForNode stageForNode;
+    std::atomic<bool> enabled{false};
+    OwnedArray<Worker> workers;
+
+    SpinLock scheduleLock; // Held by the audio thread for the duration of each parallel block
+    std::unique_ptr<Schedule> schedule;
+
+    // Only valid while the audio thread is waiting on the chains of the current block.
+    Schedule *activeSchedule{};
+    int activeNumSamples{0};
+    // Block generation (upper 32 bits), next unclaimed chain index (middle 16 bits) and chain count (lower 16 bits),
+    // packed so that a worker can never claim a chain of a block other than the one it read.
+    std::atomic<uint64> chainClaim{0};
+    std::atomic<int> chainsRemaining{0};
+    uint32 generation{0};
+
+    // Bumped to wake the sleeping workers, which wait on it with `std::atomic::wait`, so waking them never takes a lock.
+    std::atomic<uint32> wakeUps{0};
+    std::atomic<int> numSleeping{0};
+
+    const AudioBuffer<float> *graphInputBuffer{};
+    const MidiBuffer *graphInputMidi{};
+
+    void resizeWorkers(int numWorkers);
+    void wakeWorkers();
+    bool hasUnclaimedChains() const;
+    bool buildSchedule(Schedule &newSchedule) const;
+    void renderTask(Schedule &schedule, NodeTask &task, int numSamples);
+    // Claim and render chains of the active block until there are none left. Returns `true` if any were rendered.
+    bool renderChains();
+
+    // Catches topology changes the owner didn't report through `graphChanged` (e.g. connections the graph removes itself).
+    void changeListenerCallback(ChangeBroadcaster *) override { graphChanged(); }
+    // Posted after the graph's own async rebuild, so that new nodes have already been prepared.
+    void handleAsyncUpdate() override { rebuild(); }
+};
@@ -1,6 +1,7 @@
 #include "PluginManager.h"
 
 #include "ApplicationPropertiesAndCommandManager.h"
+#include "processors/SineBank.h"
 
 PluginManager::PluginManager() {
     if (auto savedPluginList = getUserSettings()->getXmlValue(PLUGIN_LIST_FILE_NAME))
@@ -38,6 +39,11 @@ void PluginManager::addPluginsToMenu(PopupMenu &menu) {
     userCreatableInternalPluginDescriptions = userCreatablePluginListInternal.getTypes();
 
     KnownPluginList::addToMenu(internalSubMenu, userCreatableInternalPluginDescriptions, pluginSortMethod);
+    PopupMenu sineBankSubMenu;
+    for (int i = 0; i < numElementsInArray(SineBank::PARTIAL_COUNT_CHOICES); i++)
+        sineBankSubMenu.addItem(SINE_BANK_PARTIALS_MENU_ID_BASE + i, String(SineBank::PARTIAL_COUNT_CHOICES[i]) + " partials");
+    internalSubMenu.addSeparator();
+    internalSubMenu.addSubMenu(SineBank::name() + " with...", sineBankSubMenu);
     KnownPluginList::addToMenu(externalSubMenu, externalPluginDescriptions, pluginSortMethod, String(), getInternalPluginDescriptions().size());
 
     menu.addSubMenu("Internal", internalSubMenu, true);
@@ -46,6 +52,9 @@ void PluginManager::addPluginsToMenu(PopupMenu &menu) {
 }
 
 PluginDescription PluginManager::getChosenType(const int menuId) {
+    const int sineBankChoice = menuId - SINE_BANK_PARTIALS_MENU_ID_BASE;
+    if (sineBankChoice >= 0 && sineBankChoice < numElementsInArray(SineBank::PARTIAL_COUNT_CHOICES))
+        return SineBank::getPluginDescription(SineBank::PARTIAL_COUNT_CHOICES[sineBankChoice]);
     int internalPluginListIndex = KnownPluginList::getIndexChosenByMenu(userCreatableInternalPluginDescriptions, menuId);
     if (internalPluginListIndex != -1)
         return userCreatableInternalPluginDescriptions[internalPluginListIndex];
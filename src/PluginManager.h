@@ -25,6 +25,8 @@ public:
 
 private:
     const String PLUGIN_LIST_FILE_NAME = "pluginList";
+    // Past any plugin list's menu ids.
+    static constexpr int SINE_BANK_PARTIALS_MENU_ID_BASE = 1 << 20;
 
     InternalPluginFormat internalFormat;
     KnownPluginList knownPluginListExternal;
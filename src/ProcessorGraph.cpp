@@ -30,21 +30,126 @@ ProcessorGraph::~ProcessorGraph() {
 }
 
 void ProcessorGraph::addProcessor(Processor *processor) {
-    static String errorMessage = "Could not create processor";
+    String errorMessage;
+    if (auto description = getDescriptionForProcessor(processor))
+        addProcessor(processor, createAudioProcessor(*description, processor->getState()[ProcessorIDs::state], errorMessage));
+}
+
+void ProcessorGraph::addProcessors(const Array<Processor *> &processors) {
+    struct PluginLoad {
+        Processor *processor;
+        const var *savedState; // Not copied, since it can be large. The tree isn't changed until all loads are done.
+        bool restoreOffMessageThread;
+        std::unique_ptr<AudioPluginInstance> audioProcessor;
+    };
+
+    // Plugin formats create their instances on the message thread (off it, they'd post to it and wait),
+    // so instances are created here. Only state restores that are safe off the message thread run concurrently.
+    std::vector<PluginLoad> loads;
+    for (auto *processor : processors) {
+        if (processorWrappers.getProcessorWrapperForProcessor(processor) != nullptr) continue;
+        if (auto description = getDescriptionForProcessor(processor)) {
+            String errorMessage;
+            auto audioProcessor = pluginManager.getFormatManager().createPluginInstance(*description, getSampleRate(), getBlockSize(), errorMessage);
+            loads.push_back({processor, &processor->getState()[ProcessorIDs::state], canRestoreStateOffMessageThread(*description), std::move(audioProcessor)});
+        }
+    }
+
+    const auto numOffMessageThread = int(std::count_if(loads.begin(), loads.end(), [](const auto &load) {
+        return load.audioProcessor != nullptr && load.restoreOffMessageThread;
+    }));
+    std::atomic<int> numRemaining{numOffMessageThread};
+    WaitableEvent allRestored;
+    {
+        ThreadPool pool(jlimit(1, SystemStats::getNumCpus(), numOffMessageThread));
+        for (auto &load : loads) {
+            if (load.audioProcessor == nullptr || !load.restoreOffMessageThread) continue;
+            pool.addJob([&load, &numRemaining, &allRestored] {
+                restoreState(*load.audioProcessor, *load.savedState);
+                if (--numRemaining == 0) allRestored.signal();
+            });
+        }
+        for (auto &load : loads)
+            if (load.audioProcessor != nullptr && !load.restoreOffMessageThread)
+                restoreState(*load.audioProcessor, *load.savedState);
+        if (numOffMessageThread > 0) allRestored.wait();
+    }
+
+    // All in one message-thread pass, so the graph only rebuilds its render sequence once for all of these nodes.
+    for (auto &load : loads)
+        addProcessor(load.processor, std::move(load.audioProcessor));
+}
+
+void ProcessorGraph::removeProcessors(const Array<Processor *> &processors) {
+    for (auto *processor : processors)
+        if (processorWrappers.getProcessorWrapperForProcessor(processor) != nullptr)
+            removeProcessor(processor);
+}
+
+std::unique_ptr<PluginDescription> ProcessorGraph::getDescriptionForProcessor(const Processor *processor) {
     auto description = pluginManager.getDescriptionForIdentifier(processor->getId());
-    auto audioProcessor = pluginManager.getFormatManager().createPluginInstance(*description, getSampleRate(), getBlockSize(), errorMessage);
-    if (processor->hasProcessorState()) {
+    // Internal plugins take their options from what follows the ':' in their identifier.
+    if (description != nullptr && processor->hasInternalOptions())
+        description->fileOrIdentifier = description->name + ":" + processor->getInternalOptions();
+    return description;
+}
+
+bool ProcessorGraph::canRestoreStateOffMessageThread(const PluginDescription &description) {
+    // Third-party formats (and many plugins) expect `setStateInformation` on the message thread, often taking
+    // a `MessageManagerLock` in it, which would deadlock with the message thread blocked waiting on the restores.
+    // Only internal processors are known to restore safely from any thread.
+    return description.pluginFormatName == InternalPluginFormat::getFormatName();
+}
+
+std::unique_ptr<AudioPluginInstance> ProcessorGraph::createAudioProcessor(const PluginDescription &description, const var &savedState, String &errorMessage) {
+    auto audioProcessor = pluginManager.getFormatManager().createPluginInstance(description, getSampleRate(), getBlockSize(), errorMessage);
+    if (audioProcessor != nullptr) restoreState(*audioProcessor, savedState);
+    return audioProcessor;
+}
+
+void ProcessorGraph::restoreState(AudioPluginInstance &audioProcessor, const var &savedState) {
+    // Binary project files load plugin state as raw bytes. XML ones are base64-encoded.
+    if (const auto *binaryState = savedState.getBinaryData()) {
+        audioProcessor.setStateInformation(binaryState->getData(), (int) binaryState->getSize());
+    } else if (savedState.isString()) {
         MemoryBlock memoryBlock;
-        memoryBlock.fromBase64Encoding(processor->getProcessorState());
-        audioProcessor->setStateInformation(memoryBlock.getData(), (int) memoryBlock.getSize());
+        memoryBlock.fromBase64Encoding(savedState.toString());
+        audioProcessor.setStateInformation(memoryBlock.getData(), (int) memoryBlock.getSize());
+    }
+}
+
+void ProcessorGraph::addProcessor(Processor *processor, std::unique_ptr<AudioPluginInstance> audioProcessor) {
+    if (audioProcessor == nullptr) {
+        jassertfalse; // Plugin could not be created
+        return;
     }
 
+    // Third-party plugins are wrapped so the graph can time them. Everything else only sees the plugin itself.
+    // Graph IO processors stay as they are, since the graph relies on their type.
+    auto *plugin = audioProcessor.get();
+    if (dynamic_cast<DefaultAudioProcessor *>(plugin) == nullptr && dynamic_cast<AudioGraphIOProcessor *>(plugin) == nullptr)
+        audioProcessor = std::make_unique<ProfiledPluginInstance>(std::move(audioProcessor));
+
     const Node::Ptr &newNode = processor->hasNodeId() ?
                                addNode(std::move(audioProcessor), processor->getNodeId()) :
                                addNode(std::move(audioProcessor));
+    parallelRenderer.graphChanged();
     if (!processor->hasNodeId()) processor->setNodeId(newNode->nodeID);
-    processorWrappers.set(newNode->nodeID, std::make_unique<StatefulAudioProcessorWrapper>
-            (dynamic_cast<AudioPluginInstance *>(newNode->getProcessor()), processor, undoManager));
+    auto processorWrapper = std::make_unique<StatefulAudioProcessorWrapper>
+            (plugin, processor, undoManager, &parameterChangeQueue, &processorWrappers.getDirtyParameters());
+    // The wrapper sets up the plugin's buses.
+    if (auto *profiledPlugin = dynamic_cast<ProfiledPluginInstance *>(newNode->getProcessor())) {
+        profiledPlugin->updateLayoutFromPlugin();
+        profiledPlugin->onLayoutChanged = [this] {
+            topologyChanged();
+            parallelRenderer.graphChanged();
+        };
+    }
+    if (auto *nodeTimer = getTimerForNode(newNode.get())) {
+        nodeTimer->setEnabled(isProfilingEnabled());
+        processorWrapper->timer = nodeTimer;
+    }
+    processorWrappers.set(newNode->nodeID, std::move(processorWrapper));
     // Added the first processor. Start the timer that flushes new processor state to their value trees.
     if (processorWrappers.size() == 1) startTimerHz(10);
 
@@ -84,13 +189,72 @@ void ProcessorGraph::removeProcessor(Processor *processor) {
         }
     }
     processorWrapper->audioProcessor->removeListener(processor);
+    parameterChangeQueue.discardChangesForProcessor(processorWrapper->audioProcessor);
     processorWrappers.erase(nodeId);
+    // Other nodes can't be left holding on to this one until the pending connection updates are applied.
+    discardPendingConnectionUpdatesForNode(nodeId);
+    AudioProcessorGraph::disconnectNode(nodeId);
     nodes.removeObject(AudioProcessorGraph::getNodeForId(nodeId));
     topologyChanged();
+    parallelRenderer.graphChanged();
     if (lastNodeID == nodeId)
         lastNodeID.uid -= 1;
 }
 
+void ProcessorGraph::prepareToPlay(double sampleRate, int estimatedSamplesPerBlock) {
+    // `prepareToPlay` also runs on the audio device's thread (e.g. when the device restarts),
+    // but pending connection updates are only ever applied on the message thread.
+    const bool isMessageThread = MessageManager::getInstance()->isThisTheMessageThread();
+    if (isMessageThread) applyPendingConnectionUpdates();
+    else pendingConnectionUpdatesApplier.triggerAsyncUpdate();
+    AudioProcessorGraph::prepareToPlay(sampleRate, estimatedSamplesPerBlock);
+    // Off the message thread, the graph prepares its nodes asynchronously without reporting a topology change,
+    // so the renderer's rebuild is posted here, to run after the graph's.
+    if (isMessageThread)
+        parallelRenderer.rebuild();
+    else
+        parallelRenderer.graphChanged();
+}
+
+void ProcessorGraph::releaseResources() {
+    parallelRenderer.clear();
+    AudioProcessorGraph::releaseResources();
+}
+
+int ProcessorGraph::getRenderStageForNode(NodeID nodeId) const {
+    if (input.getProcessorByNodeId(nodeId) != nullptr) return ParallelGraphRenderer::PRE_STAGE;
+
+    if (const auto *track = allProcessors.getTrackForNodeId(nodeId))
+        if (!track->isMaster())
+            return track->getIndex();
+
+    return ParallelGraphRenderer::POST_STAGE;
+}
+
+String ProcessorGraph::describeProcessor(const AudioProcessor *processor) const {
+    if (processor == this) return "the processor graph";
+
+    for (const auto *node : getNodes())
+        if (node->getProcessor() == processor)
+            return "\"" + processor->getName() + "\" (node " + String(node->nodeID.uid) + ")";
+    return "a processor that has since been removed";
+}
+
+ProcessorTimer *ProcessorGraph::getTimerForNode(Node *node) {
+    if (auto *defaultProcessor = dynamic_cast<DefaultAudioProcessor *>(node->getProcessor()))
+        return &defaultProcessor->getTimer();
+    if (auto *profiledPlugin = dynamic_cast<ProfiledPluginInstance *>(node->getProcessor()))
+        return &profiledPlugin->getTimer();
+    return nullptr;
+}
+
+void ProcessorGraph::setProfilingEnabled(bool enabled) {
+    timer.setEnabled(enabled);
+    for (auto *node : getNodes())
+        if (auto *nodeTimer = getTimerForNode(node))
+            nodeTimer->setEnabled(enabled);
+}
+
 bool ProcessorGraph::canAddConnection(const Connection &c) {
     if (auto *source = getNodeForId(c.source.nodeID))
         if (auto *dest = getNodeForId(c.destination.nodeID))
@@ -183,12 +347,30 @@ void ProcessorGraph::updateIoChannelEnabled(const ValueTree &channels, const Val
 
 void ProcessorGraph::resumeAudioGraphUpdatesAndApplyDiffSincePause() {
     graphUpdatesArePaused = false;
-    for (auto *connection : connectionsSincePause.connectionsToDelete)
-        valueTreeChildRemoved(connections.getState(), connection->getState(), 0);
-    for (auto *connection : connectionsSincePause.connectionsToCreate)
-        valueTreeChildAdded(connections.getState(), connection->getState());
-    connectionsSincePause.connectionsToDelete.clear();
-    connectionsSincePause.connectionsToCreate.clear();
+    applyPendingConnectionUpdates();
+}
+
+void ProcessorGraph::applyPendingConnectionUpdates() {
+    pendingConnectionUpdatesApplier.cancelPendingUpdate();
+    if (graphUpdatesArePaused) return;
+
+    // Each of these only schedules an (asynchronous, coalesced) render sequence rebuild,
+    // so the audio thread switches from the old topology to the new one in a single step.
+    for (auto *connection : pendingConnectionUpdates.connectionsToDelete)
+        AudioProcessorGraph::removeConnection(connection->toAudioConnection());
+    for (auto *connection : pendingConnectionUpdates.connectionsToCreate)
+        AudioProcessorGraph::addConnection(connection->toAudioConnection());
+    if (!pendingConnectionUpdates.connectionsToDelete.isEmpty() || !pendingConnectionUpdates.connectionsToCreate.isEmpty())
+        parallelRenderer.graphChanged();
+    pendingConnectionUpdates.connectionsToDelete.clear();
+    pendingConnectionUpdates.connectionsToCreate.clear();
+}
+
+void ProcessorGraph::discardPendingConnectionUpdatesForNode(NodeID nodeId) {
+    for (auto *pending : {&pendingConnectionUpdates.connectionsToCreate, &pendingConnectionUpdates.connectionsToDelete})
+        for (int i = pending->size() - 1; i >= 0; i--)
+            if (pending->getUnchecked(i)->getSourceNodeId() == nodeId || pending->getUnchecked(i)->getDestinationNodeId() == nodeId)
+                pending->remove(i);
 }
 
 void ProcessorGraph::valueTreeChildAdded(ValueTree &parent, ValueTree &child) {
@@ -207,5 +389,9 @@ void ProcessorGraph::valueTreeChildRemoved(ValueTree &parent, ValueTree &child,
 }
 
 void ProcessorGraph::timerCallback() {
-    startTimer(processorWrappers.flushAllParameterValuesToValueTree() ? 1000 / 50 : std::clamp(getTimerInterval() + 20, 50, 500));
+    static constexpr int MAX_PARAMETER_FLUSH_BATCH_SIZE = 256;
+    const bool flushedAny = processorWrappers.flushDirtyParameterValuesToValueTree(MAX_PARAMETER_FLUSH_BATCH_SIZE) > 0;
+    // Come straight back while there's a backlog, poll at 50Hz while parameters are changing, and back off while they aren't.
+    if (processorWrappers.getParameterFlushStats().backlog > 0) startTimer(5);
+    else startTimer(flushedAny ? 1000 / 50 : std::clamp(getTimerInterval() + 20, 50, 500));
 }
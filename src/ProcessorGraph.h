@@ -4,12 +4,17 @@
 #include "action/CreateOrDeleteConnections.h"
 #include "push2/Push2MidiCommunicator.h"
 #include "processors/StatefulAudioProcessorWrapper.h"
+#include "processors/ProcessorTimingStats.h"
+#include "processors/ProfiledPluginInstance.h"
+#include "processors/ParameterChangeQueue.h"
 #include "model/AllProcessors.h"
 #include "model/Input.h"
 #include "model/Output.h"
 #include "model/Connections.h"
 #include "model/StatefulAudioProcessorWrappers.h"
 #include "PluginManager.h"
+#include "ParallelGraphRenderer.h"
+#include "AudioThreadChecker.h"
 
 using namespace fg; // Only to disambiguate `Connection` currently
 
@@ -27,6 +32,8 @@ struct ProcessorGraph : public AudioProcessorGraph,
     void pauseAudioGraphUpdates() { graphUpdatesArePaused = true; }
     void resumeAudioGraphUpdatesAndApplyDiffSincePause();
     bool areAudioGraphUpdatesPaused() const { return graphUpdatesArePaused; }
+    // Apply connection changes now, rather than when the message loop gets to them.
+    void flushPendingConnectionUpdates() { pendingConnectionUpdatesApplier.handleUpdateNowIfNeeded(); }
 
     bool canAddConnection(const Connection &connection);
     bool removeConnection(const Connection &audioConnection) override;
@@ -53,7 +60,36 @@ struct ProcessorGraph : public AudioProcessorGraph,
         removeProcessor(processor);
     }
 
+    // Create the plugins of all the given processors (e.g. of a project being loaded), restore their states concurrently,
+    // then add them all to the graph in one pass.
+    // Plugins of formats that need the message thread are restored on it, while the others restore on a thread pool.
+    void addProcessors(const Array<Processor *> &processors);
+    // Call before the processors are cleared from the model.
+    void removeProcessors(const Array<Processor *> &processors);
+
+    void prepareToPlay(double sampleRate, int estimatedSamplesPerBlock) override;
+    void releaseResources() override;
+
+    using AudioProcessorGraph::processBlock;
+    void processBlock(AudioBuffer<float> &buffer, MidiBuffer &midiMessages) override {
+        const AudioThreadChecker::Scope checkerScope(this);
+        parameterChangeQueue.applyPendingChanges();
+        timer.time(buffer.getNumSamples(), [&] { renderBlock(buffer, midiMessages); });
+    }
+
+    // Render independent tracks concurrently on a pool of worker threads (see `ParallelGraphRenderer`).
+    void setParallelRenderingEnabled(bool enabled) { parallelRenderer.setEnabled(enabled); }
+    bool isParallelRenderingEnabled() const { return parallelRenderer.isEnabled(); }
+
+    // Time every graph callback, and every node in it (third-party plugins through their `ProfiledPluginInstance`).
+    // Stats restart each time profiling is enabled.
+    void setProfilingEnabled(bool enabled);
+    bool isProfilingEnabled() const { return timer.isEnabled(); }
+    const ProcessorTimingStats &getTimingStats() const { return timer.getStats(); }
+
 private:
+    // Declared before the wrappers posting to it.
+    ParameterChangeQueue parameterChangeQueue{*this};
     StatefulAudioProcessorWrappers processorWrappers;
 
     AllProcessors &allProcessors;
@@ -68,11 +104,40 @@ private:
     Push2MidiCommunicator &push2MidiCommunicator;
 
     bool graphUpdatesArePaused{false};
+    ProcessorTimer timer;
+    ParallelGraphRenderer parallelRenderer{*this, [this](NodeID nodeId) { return getRenderStageForNode(nodeId); }};
+    AudioThreadChecker::Reporter audioThreadReporter{[this](const AudioProcessor *processor) { return describeProcessor(processor); }};
 
-    CreateOrDeleteConnections connectionsSincePause{connections};
+    struct PendingConnectionUpdatesApplier : public AsyncUpdater {
+        explicit PendingConnectionUpdatesApplier(ProcessorGraph &graph) : graph(graph) {}
+        void handleAsyncUpdate() override { graph.applyPendingConnectionUpdates(); }
+
+    private:
+        ProcessorGraph &graph;
+    };
+
+    CreateOrDeleteConnections pendingConnectionUpdates{connections};
+    PendingConnectionUpdatesApplier pendingConnectionUpdatesApplier{*this};
 
     void addProcessor(Processor *processor);
+    void addProcessor(Processor *processor, std::unique_ptr<AudioPluginInstance> audioProcessor);
+    std::unique_ptr<PluginDescription> getDescriptionForProcessor(const Processor *processor);
+    // Call on the message thread.
+    std::unique_ptr<AudioPluginInstance> createAudioProcessor(const PluginDescription &description, const var &savedState, String &errorMessage);
+    // Thread-safe for plugin formats that `canRestoreStateOffMessageThread`.
+    static void restoreState(AudioPluginInstance &audioProcessor, const var &savedState);
+    static bool canRestoreStateOffMessageThread(const PluginDescription &description);
     void removeProcessor(Processor *processor);
+    void applyPendingConnectionUpdates();
+    void discardPendingConnectionUpdatesForNode(NodeID nodeId);
+
+    void renderBlock(AudioBuffer<float> &buffer, MidiBuffer &midiMessages) {
+        if (!parallelRenderer.process(buffer, midiMessages))
+            AudioProcessorGraph::processBlock(buffer, midiMessages);
+    }
+    int getRenderStageForNode(NodeID nodeId) const;
+    static ProcessorTimer *getTimerForNode(Node *node);
+    String describeProcessor(const AudioProcessor *processor) const;
 
     bool canAddConnection(Node *source, int sourceChannel, Node *dest, int destChannel);
     bool hasConnectionMatching(const Connection &connection);
@@ -91,17 +156,15 @@ private:
             }
         }
     }
+    // Connection changes are collected (cancelling out add/remove pairs) and applied to the audio graph together,
+    // at the end of the current message loop iteration, so a whole user action results in a single render sequence rebuild.
     void onChildAdded(fg::Connection *connection) override {
-        if (graphUpdatesArePaused)
-            connectionsSincePause.addConnection(connection->toAudioConnection(), !connection->isCustom());
-        else
-            AudioProcessorGraph::addConnection(connection->toAudioConnection());
+        pendingConnectionUpdates.addConnection(connection->toAudioConnection(), !connection->isCustom());
+        if (!graphUpdatesArePaused) pendingConnectionUpdatesApplier.triggerAsyncUpdate();
     }
     void onChildRemoved(fg::Connection *connection, int oldIndex) override {
-        if (graphUpdatesArePaused)
-            connectionsSincePause.removeConnection(connection->toAudioConnection());
-        else
-            AudioProcessorGraph::removeConnection(connection->toAudioConnection());
+        pendingConnectionUpdates.removeConnection(connection->toAudioConnection());
+        if (!graphUpdatesArePaused) pendingConnectionUpdatesApplier.triggerAsyncUpdate();
     }
     void onChildChanged(fg::Connection *, const Identifier &i) override {}
 
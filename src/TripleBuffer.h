@@ -0,0 +1,41 @@
+#pragma once
+
+#include <atomic>
+
+/*!
+ *  Lock-free hand-off of the latest of a stream of values from one producer thread to one consumer thread,
+ *  through three slots owned by the caller (indexed 0 to 2).
+ *  The producer fills the slot at `getWriteIndex` and `publish`es it. The consumer `acquire`s the latest published slot
+ *  and reads the one at `getReadIndex` until its next `acquire`.
+ *  Neither side ever waits, and a slot is never written while it's being read.
+ *  Values published faster than they're acquired are dropped, so the consumer always gets the newest one.
+ */
+struct TripleBuffer {
+    // Producer only.
+    int getWriteIndex() const noexcept { return writeIndex; }
+
+    void publish() noexcept {
+        writeIndex = latest.exchange(writeIndex | FRESH, std::memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    // Whether a slot was published since the last `acquire`. Any thread.
+    bool hasFresh() const noexcept { return (latest.load(std::memory_order_acquire) & FRESH) != 0; }
+
+    // Consumer only. Returns `false`, keeping the current read slot, if nothing was published since the last `acquire`.
+    bool acquire() noexcept {
+        // Only the consumer clears `FRESH`, so it can't be cleared between this check and the exchange.
+        if (!hasFresh()) return false;
+
+        readIndex = latest.exchange(readIndex, std::memory_order_acq_rel) & INDEX_MASK;
+        return true;
+    }
+
+    int getReadIndex() const noexcept { return readIndex; }
+
+private:
+    static constexpr int INDEX_MASK = 3, FRESH = 4;
+
+    int writeIndex{0};
+    std::atomic<int> latest{1};
+    int readIndex{2};
+};
@@ -23,7 +23,7 @@ ResetDefaultExternalInputConnectionsAction::ResetDefaultExternalInputConnections
 
         AudioProcessorGraph::NodeID destinationNodeId;
         const auto *topmostEffectProcessor = findTopmostEffectProcessor(trackToTreatAsFocused, connectionType);
-        if (const auto *destinationProcessor = findMostUpstreamAvailableProcessorConnectedTo(topmostEffectProcessor, connectionType, tracks, input)) {
+        if (const auto *destinationProcessor = findMostUpstreamAvailableProcessorConnectedTo(topmostEffectProcessor, connectionType, allProcessors, input)) {
             destinationNodeId = destinationProcessor->getNodeId();
             coalesceWith(DefaultConnectProcessor(sourceProcessor, destinationNodeId, connectionType, connections, allProcessors, processorGraph));
         }
@@ -31,28 +31,30 @@ ResetDefaultExternalInputConnectionsAction::ResetDefaultExternalInputConnections
     }
 }
 
-const Processor *ResetDefaultExternalInputConnectionsAction::findMostUpstreamAvailableProcessorConnectedTo(const Processor *processor, ConnectionType connectionType, Tracks &tracks, Input &input) {
+const Processor *ResetDefaultExternalInputConnectionsAction::findMostUpstreamAvailableProcessorConnectedTo(const Processor *processor, ConnectionType connectionType, AllProcessors &allProcessors, Input &input) {
     if (processor == nullptr) return {};
 
-    int lowestSlot = INT_MAX;
+    int lowestSlot = INT_MAX, lowestSlotTrackIndex = -1;
     const Processor *upperRightMostProcessor = nullptr;
-    AudioProcessorGraph::NodeID processorNodeId = processor->getNodeId();
     if (isAvailableForExternalInput(processor, connectionType, input))
         upperRightMostProcessor = processor;
 
-    // TODO performance improvement: only iterate over connected processors
-    for (int i = tracks.size() - 1; i >= 0; i--) {
-        const auto *track = tracks.get(i);
+    const auto processorNodeId = processor->getNodeId();
+    std::unordered_set<uint32> upstreamNodeIds{processorNodeId.uid};
+    addUpstreamNodeIds(processorNodeId, upstreamNodeIds);
+    for (const auto upstreamNodeId : upstreamNodeIds) {
+        const auto *track = allProcessors.getTrackForNodeId(AudioProcessorGraph::NodeID(upstreamNodeId));
+        if (track == nullptr) continue;
         const auto *firstProcessor = track->getFirstProcessor();
-        if (firstProcessor == nullptr) continue;
+        if (firstProcessor == nullptr || firstProcessor->getNodeId().uid != upstreamNodeId) continue;
 
-        auto firstProcessorNodeId = firstProcessor->getNodeId();
+        // Ties go to the right-most track.
         int slot = firstProcessor->getSlot();
-        if (slot < lowestSlot &&
-            isAvailableForExternalInput(firstProcessor, connectionType, input) &&
-            areProcessorsConnected(firstProcessorNodeId, processorNodeId)) {
-
+        if (slot > lowestSlot || !isAvailableForExternalInput(firstProcessor, connectionType, input)) continue;
+        const int trackIndex = track->getIndex();
+        if (slot < lowestSlot || trackIndex > lowestSlotTrackIndex) {
             lowestSlot = slot;
+            lowestSlotTrackIndex = trackIndex;
             upperRightMostProcessor = firstProcessor;
         }
     }
@@ -74,19 +76,10 @@ bool ResetDefaultExternalInputConnectionsAction::isAvailableForExternalInput(con
     return true;
 }
 
-bool ResetDefaultExternalInputConnectionsAction::areProcessorsConnected(AudioProcessorGraph::NodeID upstreamNodeId, AudioProcessorGraph::NodeID downstreamNodeId) {
-    if (upstreamNodeId == downstreamNodeId) return true;
-
-    Array<AudioProcessorGraph::NodeID> exploredDownstreamNodes;
-    for (const auto *connection : connections.getChildren()) {
-        if (connection->getSourceNodeId() == upstreamNodeId) {
-            auto otherDownstreamNodeId = connection->getDestinationNodeId();
-            if (!exploredDownstreamNodes.contains(otherDownstreamNodeId)) {
-                if (otherDownstreamNodeId == downstreamNodeId || areProcessorsConnected(otherDownstreamNodeId, downstreamNodeId))
-                    return true;
-                exploredDownstreamNodes.add(otherDownstreamNodeId);
-            }
-        }
+void ResetDefaultExternalInputConnectionsAction::addUpstreamNodeIds(AudioProcessorGraph::NodeID nodeId, std::unordered_set<uint32> &upstreamNodeIds) {
+    for (const auto *connection : connections.getConnectionsForNode(nodeId, all, true, false)) {
+        const auto upstreamNodeId = connection->getSourceNodeId();
+        if (upstreamNodeIds.insert(upstreamNodeId.uid).second)
+            addUpstreamNodeIds(upstreamNodeId, upstreamNodeIds);
     }
-    return false;
 }
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <unordered_set>
+
 #include "model/Input.h"
 #include "CreateOrDeleteConnections.h"
 #include "ProcessorGraph.h"
@@ -16,7 +18,8 @@ struct ResetDefaultExternalInputConnectionsAction : public CreateOrDeleteConnect
 private:
     // Find the upper-right-most effect processor that flows into the given processor
     // which doesn't already have incoming node connections.
-    const Processor *findMostUpstreamAvailableProcessorConnectedTo(const Processor *processor, ConnectionType connectionType, Tracks &tracks, Input &input);
+    const Processor *findMostUpstreamAvailableProcessorConnectedTo(const Processor *processor, ConnectionType connectionType, AllProcessors &allProcessors, Input &input);
     bool isAvailableForExternalInput(const Processor *processor, ConnectionType connectionType, Input &input);
-    bool areProcessorsConnected(AudioProcessorGraph::NodeID upstreamNodeId, AudioProcessorGraph::NodeID downstreamNodeId);
+    // Adds the IDs of all nodes with a path to the given node.
+    void addUpstreamNodeIds(AudioProcessorGraph::NodeID nodeId, std::unordered_set<uint32> &upstreamNodeIds);
 };
@@ -3,12 +3,15 @@
 UpdateAllDefaultConnections::UpdateAllDefaultConnections(bool makeInvalidDefaultsIntoCustom, bool resetDefaultExternalInputConnections, Tracks &tracks, Connections &connections, Input &input,
                                                          Output &output, AllProcessors &allProcessors, ProcessorGraph &processorGraph, Track *trackToTreatAsFocused)
         : CreateOrDeleteConnections(connections) {
-    for (const auto *track : tracks.getChildren()) {
+    // Default connections only depend on the processors in the same track, the master track and the project output,
+    // so only tracks where any of those changed since the last update can have stale ones.
+    for (const auto *track : allProcessors.takeTracksWithStaleDefaultConnections()) {
         for (const auto *processor : track->getAllProcessors())
             coalesceWith(UpdateProcessorDefaultConnections(processor, makeInvalidDefaultsIntoCustom, connections, output, allProcessors, processorGraph));
     }
 
     if (resetDefaultExternalInputConnections) {
+        // The reset is found against the connections after this update. `perform` and `undo` are no-ops when nothing changed.
         perform();
         auto resetAction = ResetDefaultExternalInputConnectionsAction(connections, tracks, input, allProcessors, processorGraph, trackToTreatAsFocused);
         undo();
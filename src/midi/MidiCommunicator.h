@@ -1,5 +1,8 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+
 #include <juce_audio_devices/juce_audio_devices.h>
 
 using namespace juce;
@@ -21,23 +24,35 @@ public:
 
     bool isInitialized() const { return initialized; }
 
+    // At most `MAX_MIDI_CALLBACKS` at a time.
     void addMidiInputCallback(MidiInputCallback *callbackToAdd) {
-        const ScopedLock sl(midiCallbackLock);
-        midiCallbacks.add(callbackToAdd);
+        for (auto &midiCallback : midiCallbacks) {
+            MidiInputCallback *empty = nullptr;
+            if (midiCallback.compare_exchange_strong(empty, callbackToAdd)) return;
+        }
+        jassertfalse; // Too many callbacks
     }
 
+    // Once this returns, the callback is no longer being called, and won't be again.
     void removeMidiInputCallback(MidiInputCallback *callbackToRemove) {
-        const ScopedLock sl(midiCallbackLock);
-        midiCallbacks.removeAllInstancesOf(callbackToRemove);
+        for (auto &midiCallback : midiCallbacks) {
+            auto *expected = callbackToRemove;
+            midiCallback.compare_exchange_strong(expected, nullptr);
+        }
+        // Wait out a dispatch that may have loaded the callback before it was removed.
+        while (numDispatching.load() > 0) Thread::yield();
     }
 
     bool isOutputConnected() const { return midiOutput != nullptr; }
 
+    // Called on the midi thread, which never waits on the message thread adding or removing callbacks.
     void handleIncomingMidiMessage(MidiInput *source, const MidiMessage &message) override {
         if (!message.isActiveSense()) {
-            const ScopedLock sl(midiCallbackLock);
-            for (auto &mc : midiCallbacks)
-                mc->handleIncomingMidiMessage(source, message);
+            numDispatching++;
+            for (auto &midiCallback : midiCallbacks)
+                if (auto *mc = midiCallback.load())
+                    mc->handleIncomingMidiMessage(source, message);
+            numDispatching--;
         }
     }
 
@@ -46,8 +61,10 @@ protected:
     std::unique_ptr<MidiInput> midiInput;
     std::unique_ptr<MidiOutput> midiOutput;
 
-    Array<MidiInputCallback *> midiCallbacks;
-    CriticalSection midiCallbackLock;
+    static constexpr int MAX_MIDI_CALLBACKS = 16;
+
+    std::array<std::atomic<MidiInputCallback *>, MAX_MIDI_CALLBACKS> midiCallbacks{};
+    std::atomic<int> numDispatching{0};
 
     virtual void initialize() { midiInput->start(); }
 
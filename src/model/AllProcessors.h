@@ -1,12 +1,25 @@
 #pragma once
 
+#include <unordered_map>
+#include <unordered_set>
+
 #include "Tracks.h"
+#include "Connections.h"
 #include "Input.h"
 #include "Output.h"
 
-struct AllProcessors : private StatefulList<Processor>::Listener {
-    AllProcessors(Tracks &tracks, Input &input, Output &output) : tracks(tracks), input(input), output(output) {
+/*!
+ *  Every processor in the project: the project's input and output processors, and the processors of each track.
+ *  Keeps a hash index from node ID to processor (and to its track) in sync through the child-list callbacks,
+ *  so node ID lookups on the connection paths don't scan every list.
+ *  Also tracks which tracks' default connections may be stale, for `UpdateAllDefaultConnections`.
+ */
+struct AllProcessors : private StatefulList<Processor>::Listener, private StatefulList<Track>::Listener, private StatefulList<fg::Connection>::Listener {
+    AllProcessors(Tracks &tracks, Connections &connections, Input &input, Output &output)
+            : tracks(tracks), connections(connections), input(input), output(output) {
+        tracks.addChildListener(this);
         tracks.addProcessorListener(this);
+        connections.addChildListener(this);
         input.addChildListener(this);
         output.addChildListener(this);
     }
@@ -14,18 +27,45 @@ struct AllProcessors : private StatefulList<Processor>::Listener {
     ~AllProcessors() {
         output.removeChildListener(this);
         input.removeChildListener(this);
+        connections.removeChildListener(this);
         tracks.removeProcessorListener(this);
+        tracks.removeChildListener(this);
     }
 
     Processor *getMostRecentlyCreatedProcessor() const { return mostRecentlyCreatedProcessor; }
 
+    Array<Processor *> getAllProcessors() const {
+        Array<Processor *> processors(input.getChildren());
+        processors.addArray(output.getChildren());
+        for (const auto *track : tracks.getChildren())
+            processors.addArray(track->getProcessorLane()->getChildren());
+        return processors;
+    }
+
     Processor *getProcessorByNodeId(juce::AudioProcessorGraph::NodeID nodeId) const {
-        if (auto *processor = input.getProcessorByNodeId(nodeId)) return processor;
-        if (auto *processor = output.getProcessorByNodeId(nodeId)) return processor;
-        if (auto *processor = tracks.getProcessorByNodeId(nodeId)) return processor;
-        return nullptr;
+        const auto entry = entryForNodeId.find(nodeId.uid);
+        return entry != entryForNodeId.end() ? entry->second.processor : nullptr;
+    }
+    // `nullptr` for the project's input and output processors.
+    Track *getTrackForNodeId(juce::AudioProcessorGraph::NodeID nodeId) const {
+        const auto entry = entryForNodeId.find(nodeId.uid);
+        return entry != entryForNodeId.end() ? entry->second.track : nullptr;
     }
 
+    // The tracks whose processors, or connections from or to them, changed since the last call, in track order.
+    // All tracks if anything changed that every track's default connections depend on:
+    // the master track, or the project's input and output processors.
+    Array<Track *> takeTracksWithStaleDefaultConnections() {
+        Array<Track *> staleTracks;
+        for (auto *track : tracks.getChildren())
+            if (allDefaultConnectionsStale || tracksWithStaleDefaultConnections.count(track) > 0)
+                staleTracks.add(track);
+        tracksWithStaleDefaultConnections.clear();
+        allDefaultConnectionsStale = false;
+        return staleTracks;
+    }
+    void markAllDefaultConnectionsStale() { allDefaultConnectionsStale = true; }
+
     void appendIOProcessor(const PluginDescription &description) {
         if (InternalPluginFormat::isAudioInputProcessor(description.name)) {
             input.append(Processor::initState(description));
@@ -46,17 +86,105 @@ struct AllProcessors : private StatefulList<Processor>::Listener {
     }
 
 private:
-    ListenerList<Listener> listeners;
+    struct IndexEntry {
+        Processor *processor;
+        Track *track;
+    };
+
     Processor *mostRecentlyCreatedProcessor = nullptr;
+    std::unordered_map<uint32, IndexEntry> entryForNodeId;
+    std::unordered_set<const Track *> tracksWithStaleDefaultConnections;
+    bool allDefaultConnectionsStale = true;
+    // The ID each processor is indexed under, since a processor's node ID is only assigned after it's added.
+    std::unordered_map<const Processor *, uint32> nodeIdForProcessor;
 
     Tracks &tracks;
+    Connections &connections;
     Input &input;
     Output &output;
 
+    static bool affectsDefaultConnections(const Identifier &i) {
+        return i == ProcessorIDs::slot || i == ProcessorIDs::nodeId || i == ProcessorIDs::initialized ||
+               i == ProcessorIDs::acceptsMidi || i == ProcessorIDs::producesMidi || i == ProcessorIDs::allowDefaultConnections;
+    }
+
+    // Other tracks connect to the master track and the project output by default, so changes to those affect every track.
+    void markDefaultConnectionsStale(const Track *track) {
+        if (track == nullptr || track->isMaster()) allDefaultConnectionsStale = true;
+        else tracksWithStaleDefaultConnections.insert(track);
+    }
+    // A connection change only affects the defaults of the tracks at either end of it.
+    void markConnectionEndStale(juce::AudioProcessorGraph::NodeID nodeId) {
+        const auto entry = entryForNodeId.find(nodeId.uid);
+        if (entry != entryForNodeId.end() && entry->second.track != nullptr)
+            tracksWithStaleDefaultConnections.insert(entry->second.track);
+    }
+
+    void index(Processor *processor, Track *track) {
+        unindex(processor);
+        const auto nodeId = processor->getNodeId();
+        if (nodeId == juce::AudioProcessorGraph::NodeID{}) return;
+
+        entryForNodeId[nodeId.uid] = {processor, track};
+        nodeIdForProcessor[processor] = nodeId.uid;
+    }
+    void unindex(const Processor *processor) {
+        const auto nodeId = nodeIdForProcessor.find(processor);
+        if (nodeId == nodeIdForProcessor.end()) return;
+
+        const auto entry = entryForNodeId.find(nodeId->second);
+        if (entry != entryForNodeId.end() && entry->second.processor == processor) entryForNodeId.erase(entry);
+        nodeIdForProcessor.erase(nodeId);
+    }
+
     void onChildAdded(Processor *processor) override {
         mostRecentlyCreatedProcessor = processor;
+        auto *track = tracks.getTrackForProcessor(processor);
+        index(processor, track);
+        markDefaultConnectionsStale(track);
     }
     void onChildRemoved(Processor *processor, int oldIndex) override {
+        const auto nodeId = nodeIdForProcessor.find(processor);
+        const auto entry = nodeId != nodeIdForProcessor.end() ? entryForNodeId.find(nodeId->second) : entryForNodeId.end();
+        markDefaultConnectionsStale(entry != entryForNodeId.end() ? entry->second.track : nullptr);
+        unindex(processor);
         if (processor == mostRecentlyCreatedProcessor) mostRecentlyCreatedProcessor = nullptr;
     }
+    void onChildChanged(Processor *processor, const Identifier &i) override {
+        if (!affectsDefaultConnections(i)) return;
+
+        auto *track = tracks.getTrackForProcessor(processor);
+        if (i == ProcessorIDs::nodeId) index(processor, track);
+        markDefaultConnectionsStale(track);
+    }
+
+    // Track I/O processors that already exist when the track is created aren't announced individually.
+    void onChildAdded(Track *track) override {
+        for (auto *processor : track->getAllProcessors())
+            if (processor != nullptr) index(processor, track);
+        markDefaultConnectionsStale(track);
+    }
+    // A removed track deletes its processors without announcing each removal.
+    void onChildRemoved(Track *track, int oldIndex) override {
+        for (auto entry = entryForNodeId.begin(); entry != entryForNodeId.end();) {
+            if (entry->second.track == track) {
+                nodeIdForProcessor.erase(entry->second.processor);
+                entry = entryForNodeId.erase(entry);
+            } else {
+                ++entry;
+            }
+        }
+        if (track->getAllProcessors().contains(mostRecentlyCreatedProcessor)) mostRecentlyCreatedProcessor = nullptr;
+        if (track->isMaster()) allDefaultConnectionsStale = true;
+        tracksWithStaleDefaultConnections.erase(track);
+    }
+    void onChildChanged(Track *track, const Identifier &i) override {
+        if (i == TrackIDs::isMaster) allDefaultConnectionsStale = true;
+    }
+
+    void onChildAdded(fg::Connection *connection) override {
+        markConnectionEndStale(connection->getSourceNodeId());
+        markConnectionEndStale(connection->getDestinationNodeId());
+    }
+    void onChildRemoved(fg::Connection *connection, int oldIndex) override { onChildAdded(connection); }
 };
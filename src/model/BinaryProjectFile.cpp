@@ -0,0 +1,131 @@
+#include "BinaryProjectFile.h"
+
+#include "Processor.h"
+
+static const uint32 MAGIC = ByteOrder::littleEndianInt("FGPB");
+static constexpr uint32 FORMAT_VERSION = 1;
+static constexpr int64 HEADER_SIZE = 16, SECTION_ENTRY_SIZE = 24, SECTION_ALIGNMENT = 8;
+
+enum class SectionType : uint32 { tree = 1, pluginState = 2 };
+
+static int64 align(int64 offset) { return (offset + SECTION_ALIGNMENT - 1) / SECTION_ALIGNMENT * SECTION_ALIGNMENT; }
+
+static void forEachProcessor(ValueTree tree, const std::function<void(ValueTree &)> &callback) {
+    if (Processor::isType(tree)) return callback(tree);
+    for (auto child : tree)
+        forEachProcessor(child, callback);
+}
+
+bool BinaryProjectFile::isBinaryProjectFile(const File &file) {
+    FileInputStream stream(file);
+    return stream.openedOk() && uint32(stream.readInt()) == MAGIC;
+}
+
+Result BinaryProjectFile::write(const ValueTree &projectState, const GetPluginState &getPluginState, const File &file) {
+    struct Section {
+        SectionType type;
+        uint32 key;
+        MemoryBlock data;
+    };
+    std::vector<Section> sections;
+
+    // Move plugin states out of (a copy of) the tree, into their own sections.
+    auto tree = projectState.createCopy();
+    forEachProcessor(tree, [&](ValueTree &processorState) {
+        if (!processorState.hasProperty(ProcessorIDs::nodeId)) return;
+
+        MemoryBlock pluginState;
+        if (!getPluginState(processorState, pluginState)) {
+            // Not instantiated. Keep whatever state it was loaded with.
+            const auto &savedState = processorState[ProcessorIDs::state];
+            if (auto *binaryState = savedState.getBinaryData()) pluginState = *binaryState;
+            else if (savedState.isString()) pluginState.fromBase64Encoding(savedState.toString());
+        }
+        if (pluginState.getSize() > 0)
+            sections.push_back({SectionType::pluginState, Processor::getNodeId(processorState).uid, std::move(pluginState)});
+        processorState.removeProperty(ProcessorIDs::state, nullptr);
+    });
+
+    MemoryOutputStream treeStream;
+    tree.writeToStream(treeStream);
+    sections.insert(sections.begin(), {SectionType::tree, 0, treeStream.getMemoryBlock()});
+
+    TemporaryFile temporaryFile(file);
+    {
+        FileOutputStream stream(temporaryFile.getFile());
+        if (!stream.openedOk())
+            return Result::fail(TRANS("Could not open \"") + file.getFullPathName() + TRANS("\" for writing"));
+
+        stream.writeInt(int(MAGIC));
+        stream.writeInt(int(FORMAT_VERSION));
+        stream.writeInt(int(sections.size()));
+        stream.writeInt(0);
+
+        int64 offset = align(HEADER_SIZE + SECTION_ENTRY_SIZE * int64(sections.size()));
+        for (const auto &section : sections) {
+            stream.writeInt(int(section.type));
+            stream.writeInt(int(section.key));
+            stream.writeInt64(offset);
+            stream.writeInt64(int64(section.data.getSize()));
+            offset = align(offset + int64(section.data.getSize()));
+        }
+        for (const auto &section : sections) {
+            stream.writeRepeatedByte(0, size_t(align(stream.getPosition()) - stream.getPosition()));
+            stream.write(section.data.getData(), section.data.getSize());
+        }
+
+        stream.flush();
+        if (stream.getStatus().failed())
+            return Result::fail(TRANS("Could not save the project file"));
+    }
+    if (!temporaryFile.overwriteTargetFileWithTemporary())
+        return Result::fail(TRANS("Could not save the project file"));
+
+    return Result::ok();
+}
+
+Result BinaryProjectFile::read(const File &file, ValueTree &projectState) {
+    const MemoryMappedFile mappedFile(file, MemoryMappedFile::readOnly);
+    const auto *data = static_cast<const char *>(mappedFile.getData());
+    const auto fileSize = int64(mappedFile.getSize());
+    if (data == nullptr)
+        return Result::fail(TRANS("Could not open \"") + file.getFullPathName() + "\"");
+    if (fileSize < HEADER_SIZE || ByteOrder::littleEndianInt(data) != MAGIC)
+        return Result::fail(TRANS("Not a valid project file"));
+    if (ByteOrder::littleEndianInt(data + 4) > FORMAT_VERSION)
+        return Result::fail(TRANS("This project was saved by a newer version of FlowGrid"));
+
+    const auto numSections = int64(ByteOrder::littleEndianInt(data + 8));
+    if (numSections > (fileSize - HEADER_SIZE) / SECTION_ENTRY_SIZE)
+        return Result::fail(TRANS("The project file is corrupt"));
+
+    std::unordered_map<uint32, ValueTree> processorStateForNodeId;
+    for (int64 i = 0; i < numSections; i++) {
+        const auto *entry = data + HEADER_SIZE + i * SECTION_ENTRY_SIZE;
+        const auto type = SectionType(ByteOrder::littleEndianInt(entry));
+        const auto key = ByteOrder::littleEndianInt(entry + 4);
+        const auto offset = int64(ByteOrder::littleEndianInt64(entry + 8));
+        const auto size = int64(ByteOrder::littleEndianInt64(entry + 16));
+        if (offset < 0 || size < 0 || offset > fileSize || size > fileSize - offset)
+            return Result::fail(TRANS("The project file is corrupt"));
+
+        switch (type) {
+            case SectionType::tree:
+                projectState = ValueTree::readFromData(data + offset, size_t(size));
+                if (!projectState.isValid()) return Result::fail(TRANS("The project file is corrupt"));
+                forEachProcessor(projectState, [&](ValueTree &processorState) {
+                    processorStateForNodeId[Processor::getNodeId(processorState).uid] = processorState;
+                });
+                break;
+            case SectionType::pluginState: {
+                // The tree section is always first.
+                auto processorState = processorStateForNodeId.find(key);
+                if (processorState != processorStateForNodeId.end())
+                    processorState->second.setProperty(ProcessorIDs::state, var(data + offset, size_t(size)), nullptr);
+                break;
+            }
+        }
+    }
+
+    return projectState.isValid() ? Result::ok() : Result::fail(TRANS("The project file is corrupt"));
+}
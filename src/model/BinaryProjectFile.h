@@ -0,0 +1,28 @@
+#pragma once
+
+#include <juce_data_structures/juce_data_structures.h>
+
+using namespace juce;
+
+/*!
+ *  Indexed binary project container, loaded much faster than the XML `.smp` format for projects with large plugin states.
+ *
+ *  Layout (all integers little-endian):
+ *   * header: magic `FGPB`, format version, section count, reserved,
+ *   * section table: type, key, byte offset and byte size of each section,
+ *   * sections, each 8-byte aligned:
+ *     - one _tree_ section: the project `ValueTree` in JUCE's binary stream format, without any plugin states,
+ *     - one _plugin state_ section per processor that has one: the raw `getStateInformation` bytes, keyed by node ID.
+ *
+ *  Files are read through a `MemoryMappedFile`, so only the pages of the sections actually used are read from disk.
+ *  Plugin states come back as binary `state` properties, so they're never base64-encoded or decoded.
+ */
+struct BinaryProjectFile {
+    static bool isBinaryProjectFile(const File &file);
+
+    // Fill in the raw plugin state of the given processor, returning `false` if there is none.
+    using GetPluginState = std::function<bool(const ValueTree &processorState, MemoryBlock &pluginState)>;
+
+    static Result write(const ValueTree &projectState, const GetPluginState &getPluginState, const File &file);
+    static Result read(const File &file, ValueTree &projectState);
+};
@@ -36,30 +36,110 @@ Processor *Connections::findDefaultDestinationProcessor(const Processor *sourceP
     return {};
 }
 
-bool Connections::isNodeConnected(AudioProcessorGraph::NodeID nodeId) const {
-    for (const auto *connection : children) {
-        if (connection->getSourceNodeId() == nodeId)
-            return true;
-    }
-    return false;
-}
-
 static bool channelMatchesConnectionType(int channel, ConnectionType connectionType) {
     if (connectionType == all) return true;
     return (connectionType == audio && channel != AudioProcessorGraph::midiChannelIndex) ||
            (connectionType == midi && channel == AudioProcessorGraph::midiChannelIndex);
 }
 
+static ConnectionType getConnectionTypeForChannel(int channel) {
+    return channel == AudioProcessorGraph::midiChannelIndex ? midi : audio;
+}
+
+bool Connections::isNodeConnected(AudioProcessorGraph::NodeID nodeId) const {
+    const auto nodeConnections = connectionsForNodeId.find(nodeId.uid);
+    if (nodeConnections == connectionsForNodeId.end()) return false;
+
+    return !nodeConnections->second.outgoing[audio].isEmpty() || !nodeConnections->second.outgoing[midi].isEmpty();
+}
+
 Array<fg::Connection *> Connections::getConnectionsForNode(const Processor *processor, ConnectionType connectionType, bool incoming, bool outgoing, bool includeCustom, bool includeDefault) {
+    return getConnectionsForNode(processor->getNodeId(), connectionType, incoming, outgoing, includeCustom, includeDefault);
+}
+
+Array<fg::Connection *> Connections::getConnectionsForNode(AudioProcessorGraph::NodeID processorNodeId, ConnectionType connectionType, bool incoming, bool outgoing, bool includeCustom, bool includeDefault) {
     Array<fg::Connection *> nodeConnections;
-    for (auto *connection : children) {
-        if ((connection->isCustom() && !includeCustom) || (!connection->isCustom() && !includeDefault))
-            continue;
+    const auto entry = connectionsForNodeId.find(processorNodeId.uid);
+    if (entry == connectionsForNodeId.end()) return nodeConnections;
 
-        auto processorNodeId = processor->getNodeId();
-        if ((incoming && connection->getDestinationNodeId() == processorNodeId && channelMatchesConnectionType(connection->getDestinationChannel(), connectionType)) ||
-            (outgoing && connection->getSourceNodeId() == processorNodeId && channelMatchesConnectionType(connection->getSourceChannel(), connectionType)))
+    const auto addMatching = [&](const Array<fg::Connection *> &connections, bool skipIncoming) {
+        for (auto *connection : connections) {
+            if ((connection->isCustom() && !includeCustom) || (!connection->isCustom() && !includeDefault))
+                continue;
+            // A connection from the node back to itself was already added as an incoming connection.
+            if (skipIncoming && connection->getDestinationNodeId() == processorNodeId &&
+                channelMatchesConnectionType(connection->getDestinationChannel(), connectionType))
+                continue;
             nodeConnections.add(connection);
+        }
+    };
+    for (auto type : {audio, midi}) {
+        if (connectionType != all && connectionType != type) continue;
+        if (incoming) addMatching(entry->second.incoming[type], false);
+        if (outgoing) addMatching(entry->second.outgoing[type], incoming);
     }
+    // In list order, as a scan of the whole list would return them, so actions built from these replay in the same order.
+    std::sort(nodeConnections.begin(), nodeConnections.end(), [this](fg::Connection *a, fg::Connection *b) { return indexOf(a) < indexOf(b); });
     return nodeConnections;
 }
+
+void Connections::index(fg::Connection *connection) {
+    const auto audioConnection = connection->toAudioConnection();
+    indexedAudioConnection[connection] = audioConnection;
+    connectionsForNodeId[audioConnection.source.nodeID.uid].outgoing[getConnectionTypeForChannel(audioConnection.source.channelIndex)].add(connection);
+    connectionsForNodeId[audioConnection.destination.nodeID.uid].incoming[getConnectionTypeForChannel(audioConnection.destination.channelIndex)].add(connection);
+    // Keep the first of any duplicates, as a scan in list order would.
+    connectionForAudioConnection.emplace(audioConnection, connection);
+}
+
+void Connections::unindex(fg::Connection *connection) {
+    const auto indexed = indexedAudioConnection.find(connection);
+    if (indexed == indexedAudioConnection.end()) return;
+
+    const auto audioConnection = indexed->second;
+    indexedAudioConnection.erase(indexed);
+
+    const auto removeFrom = [&](uint32 nodeId, bool isOutgoing, int channel) {
+        const auto entry = connectionsForNodeId.find(nodeId);
+        if (entry == connectionsForNodeId.end()) return;
+
+        auto &nodeConnections = entry->second;
+        (isOutgoing ? nodeConnections.outgoing : nodeConnections.incoming)[getConnectionTypeForChannel(channel)].removeFirstMatchingValue(connection);
+        for (auto type : {audio, midi})
+            if (!nodeConnections.incoming[type].isEmpty() || !nodeConnections.outgoing[type].isEmpty()) return;
+        connectionsForNodeId.erase(entry);
+    };
+    removeFrom(audioConnection.source.nodeID.uid, true, audioConnection.source.channelIndex);
+    removeFrom(audioConnection.destination.nodeID.uid, false, audioConnection.destination.channelIndex);
+
+    const auto match = connectionForAudioConnection.find(audioConnection);
+    if (match == connectionForAudioConnection.end() || match->second != connection) return;
+
+    connectionForAudioConnection.erase(match);
+    // Fall back to a remaining duplicate, if there is one.
+    const auto entry = connectionsForNodeId.find(audioConnection.source.nodeID.uid);
+    if (entry == connectionsForNodeId.end()) return;
+    for (auto *duplicate : entry->second.outgoing[getConnectionTypeForChannel(audioConnection.source.channelIndex)]) {
+        if (duplicate->toAudioConnection() == audioConnection) {
+            connectionForAudioConnection.emplace(audioConnection, duplicate);
+            return;
+        }
+    }
+}
+
+void Connections::onChildChanged(fg::Connection *connection, const Identifier &i) {
+    if (i == ConnectionIDs::sourceNodeId || i == ConnectionIDs::sourceChannelIndex ||
+        i == ConnectionIDs::destinationNodeId || i == ConnectionIDs::destinationChannelIndex) {
+        unindex(connection);
+        index(connection);
+    }
+}
+
+// The per-node lists are kept in list order, so rebuild them when the list is reordered.
+void Connections::onOrderChanged() {
+    connectionsForNodeId.clear();
+    connectionForAudioConnection.clear();
+    indexedAudioConnection.clear();
+    for (auto *connection : children)
+        index(connection);
+}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <unordered_map>
+
 #include "Tracks.h"
 #include "ConnectionType.h"
 #include "Connection.h"
@@ -25,12 +27,13 @@ struct Connections : public Stateful<Connections>, StatefulList<fg::Connection>
     Array<fg::Connection *> getConnectionsForNode(const Processor *processor, ConnectionType connectionType,
                                                   bool incoming = true, bool outgoing = true,
                                                   bool includeCustom = true, bool includeDefault = true);
+    Array<fg::Connection *> getConnectionsForNode(AudioProcessorGraph::NodeID nodeId, ConnectionType connectionType,
+                                                  bool incoming = true, bool outgoing = true,
+                                                  bool includeCustom = true, bool includeDefault = true);
 
     fg::Connection *getConnectionMatching(const AudioProcessorGraph::Connection &connection) const {
-        for (auto *child : children)
-            if (child->toAudioConnection() == connection)
-                return child;
-        return nullptr;
+        const auto match = connectionForAudioConnection.find(connection);
+        return match != connectionForAudioConnection.end() ? match->second : nullptr;
     }
 
     void append(const fg::Connection *connection) {
@@ -39,14 +42,38 @@ struct Connections : public Stateful<Connections>, StatefulList<fg::Connection>
     }
     void removeAudioConnection(const AudioProcessorGraph::Connection audioConnection) {
         if (auto *connection = getConnectionMatching(audioConnection)) {
-            remove(connection->getIndex());
+            remove(connection->getState());
         }
     }
 
-
 protected:
     fg::Connection *createNewObject(const ValueTree &tree) override { return new fg::Connection(tree); }
+    void onChildAdded(fg::Connection *connection) override { index(connection); }
+    void onChildRemoved(fg::Connection *connection, int oldIndex) override { unindex(connection); }
+    void onChildChanged(fg::Connection *connection, const Identifier &i) override;
+    void onOrderChanged() override;
 
 private:
+    struct AudioConnectionHash {
+        size_t operator()(const AudioProcessorGraph::Connection &connection) const noexcept {
+            const auto nodes = uint64(connection.source.nodeID.uid) << 32 | connection.destination.nodeID.uid;
+            const auto channels = uint64(uint32(connection.source.channelIndex)) << 32 | uint32(connection.destination.channelIndex);
+            return std::hash<uint64>()(nodes) ^ (std::hash<uint64>()(channels) * 31);
+        }
+    };
+
+    // Each node's connections, in list order, split by the connection type of the channel at that node's end.
+    struct NodeConnections {
+        Array<fg::Connection *> incoming[2], outgoing[2];
+    };
+
     Tracks &tracks;
+
+    std::unordered_map<uint32, NodeConnections> connectionsForNodeId;
+    std::unordered_map<AudioProcessorGraph::Connection, fg::Connection *, AudioConnectionHash> connectionForAudioConnection;
+    // What each connection was indexed as, in case its properties change while it's in the list.
+    std::unordered_map<const fg::Connection *, AudioProcessorGraph::Connection> indexedAudioConnection;
+
+    void index(fg::Connection *connection);
+    void unindex(fg::Connection *connection);
 };
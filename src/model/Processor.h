@@ -25,6 +25,7 @@ ID(acceptsMidi)
 ID(producesMidi)
 ID(deviceName)
 ID(state)
+ID(internalOptions)
 ID(allowDefaultConnections)
 ID(pluginWindowType)
 ID(pluginWindowX)
@@ -39,7 +40,18 @@ struct Processor : public Stateful<Processor>, public AudioProcessorListener {
 
     static ValueTree initState(const PluginDescription &description) {
         ValueTree state(getIdentifier());
-        state.setProperty(ProcessorIDs::id, description.createIdentifierString(), nullptr);
+        // Internal plugins created with options carry them after the ':' in their identifier.
+        // They're saved separately, so the processor is still found by the identifier of the plugin without them.
+        const auto internalOptions = description.pluginFormatName == InternalPluginFormat::getFormatName()
+                                     ? description.fileOrIdentifier.fromFirstOccurrenceOf(":", false, false) : String();
+        if (internalOptions.isNotEmpty()) {
+            auto descriptionWithoutOptions = description;
+            descriptionWithoutOptions.fileOrIdentifier = description.name + ":";
+            state.setProperty(ProcessorIDs::id, descriptionWithoutOptions.createIdentifierString(), nullptr);
+            state.setProperty(ProcessorIDs::internalOptions, internalOptions, nullptr);
+        } else {
+            state.setProperty(ProcessorIDs::id, description.createIdentifierString(), nullptr);
+        }
         state.setProperty(ProcessorIDs::name, description.name, nullptr);
         state.setProperty(ProcessorIDs::allowDefaultConnections, true, nullptr);
         state.setProperty(ProcessorIDs::pluginWindowType, static_cast<int>(PluginWindowType::none), nullptr);
@@ -60,6 +72,9 @@ struct Processor : public Stateful<Processor>, public AudioProcessorListener {
     bool hasNodeId() const { return state.hasProperty(ProcessorIDs::nodeId); }
     String getProcessorState() const { return state[ProcessorIDs::state]; }
     bool hasProcessorState() const { return state.hasProperty(ProcessorIDs::state); }
+    // What an internal plugin is constructed with (e.g. a Sine Bank's partial count), before its parameters are created.
+    String getInternalOptions() const { return state[ProcessorIDs::internalOptions]; }
+    bool hasInternalOptions() const { return state.hasProperty(ProcessorIDs::internalOptions); }
     bool isInitialized() const { return state[ProcessorIDs::initialized]; }
     bool isBypassed() const { return state[ProcessorIDs::bypassed]; }
     bool acceptsMidi() const { return state[ProcessorIDs::acceptsMidi]; }
@@ -95,6 +110,7 @@ struct Processor : public Stateful<Processor>, public AudioProcessorListener {
     void setDeviceName(const String &deviceName) { state.setProperty(ProcessorIDs::deviceName, deviceName, nullptr); }
     void setSlot(int slot) { state.setProperty(ProcessorIDs::slot, slot, nullptr); }
     void setProcessorState(const String &processorState) { state.setProperty(ProcessorIDs::state, processorState, nullptr); }
+    void setInternalOptions(const String &internalOptions) { state.setProperty(ProcessorIDs::internalOptions, internalOptions, nullptr); }
     void setInitialized(bool initialized) { state.setProperty(ProcessorIDs::initialized, initialized, nullptr); }
     void setBypassed(bool bypassed, UndoManager *undoManager = nullptr) { state.setProperty(ProcessorIDs::bypassed, bypassed, undoManager); }
     void setAcceptsMidi(bool acceptsMidi) { state.setProperty(ProcessorIDs::acceptsMidi, acceptsMidi, nullptr); }
@@ -15,10 +15,11 @@
 #include "processors/TrackOutputProcessor.h"
 #include "processors/SineBank.h"
 #include "ApplicationPropertiesAndCommandManager.h"
+#include "BinaryProjectFile.h"
 
 Project::Project(View &view, Tracks &tracks, Connections &connections, Input &input, Output &output,
                  AllProcessors &allProcessors, ProcessorGraph &processorGraph, UndoManager &undoManager, PluginManager &pluginManager, AudioDeviceManager &deviceManager)
-        : FileBasedDocument(getFilenameSuffix(), "*" + getFilenameSuffix(), "Load a project", "Save project"),
+        : FileBasedDocument(getFilenameSuffix(), "*" + getFilenameSuffix() + ";*" + getBinaryFilenameSuffix(), "Load a project", "Save project"),
           view(view),
           tracks(tracks),
           connections(connections),
@@ -38,11 +39,138 @@ Project::Project(View &view, Tracks &tracks, Connections &connections, Input &in
     undoManager.addChangeListener(this);
 }
 
+struct Project::StreamingLoader : private Timer {
+    StreamingLoader(Project &project, ValueTree tracksState, ValueTree connectionsState) : project(project) {
+        project.tracks.getState().copyPropertiesFrom(tracksState, nullptr);
+        project.connections.getState().copyPropertiesFrom(connectionsState, nullptr);
+        for (int originalIndex = 0; tracksState.getNumChildren() > 0; originalIndex++) {
+            auto track = tracksState.getChild(0);
+            tracksState.removeChild(0, nullptr);
+            // Type information is not saved in XML.
+            track.setProperty(TrackIDs::isMaster, bool(track[TrackIDs::isMaster]), nullptr);
+            track.setProperty(TrackIDs::selected, bool(track[TrackIDs::selected]), nullptr);
+            // The master track goes first, since every other track's output goes through it.
+            const int pendingIndex = bool(track[TrackIDs::isMaster]) ? 0 : pendingTracks.size();
+            pendingTracks.insert(pendingIndex, track);
+            pendingTrackOriginalIndices.insert(pendingIndex, originalIndex);
+        }
+        while (connectionsState.getNumChildren() > 0) {
+            pendingConnections.add(connectionsState.getChild(0));
+            connectionsState.removeChild(0, nullptr);
+        }
+        numTracks = pendingTracks.size();
+
+        project.processorGraph.addProcessors(project.allProcessors.getAllProcessors());
+        if (!pendingTracks.isEmpty() && bool(pendingTracks.getFirst()[TrackIDs::isMaster])) loadNextTrack();
+        attachConnections(false);
+        startTimer(1);
+    }
+
+    // Load the remaining tracks right away.
+    void finishNow() {
+        const BatchedUpdates::Scope batchedUpdates;
+        while (!pendingTracks.isEmpty())
+            loadNextTrack();
+        finish();
+    }
+
+private:
+    Project &project;
+    Array<ValueTree> pendingTracks, pendingConnections;
+    Array<int> pendingTrackOriginalIndices, loadedTrackOriginalIndices;
+    int numTracks = 0;
+
+    void timerCallback() override {
+        const BatchedUpdates::Scope batchedUpdates;
+        if (pendingTracks.isEmpty()) return finish();
+
+        loadNextTrack();
+        attachConnections(false);
+    }
+
+    void loadNextTrack() {
+        auto trackState = pendingTracks.removeAndReturn(0);
+        const int originalIndex = pendingTrackOriginalIndices.removeAndReturn(0);
+        // Keep the saved track order, among the tracks loaded so far.
+        int index = 0;
+        while (index < loadedTrackOriginalIndices.size() && loadedTrackOriginalIndices.getUnchecked(index) < originalIndex) index++;
+        loadedTrackOriginalIndices.insert(index, originalIndex);
+
+        project.tracks.add(trackState, jmin(index, project.tracks.size()));
+        if (auto *track = project.tracks.getChildForState(trackState)) {
+            Array<Processor *> processors;
+            for (auto *processor : track->getAllProcessors())
+                if (processor != nullptr) processors.add(processor);
+            project.processorGraph.addProcessors(processors);
+        }
+        project.loadProgress = double(numTracks - pendingTracks.size()) / double(numTracks + 1);
+    }
+
+    // Attach each pending connection once both of its processors are loaded, unless it's already there.
+    // When `finishing`, drop the ones that never will be (e.g. because a track was deleted while loading).
+    void attachConnections(bool finishing) {
+        for (int i = 0; i < pendingConnections.size();) {
+            const auto &connection = pendingConnections.getReference(i);
+            if (project.allProcessors.getProcessorByNodeId(fg::Connection::getSourceNodeId(connection)) != nullptr &&
+                project.allProcessors.getProcessorByNodeId(fg::Connection::getDestinationNodeId(connection)) != nullptr) {
+                const AudioProcessorGraph::Connection audioConnection{{fg::Connection::getSourceNodeId(connection),      fg::Connection::getSourceChannel(connection)},
+                                                                      {fg::Connection::getDestinationNodeId(connection), fg::Connection::getDestinationChannel(connection)}};
+                if (project.connections.getConnectionMatching(audioConnection) == nullptr)
+                    project.connections.getState().appendChild(connection, nullptr);
+                pendingConnections.remove(i);
+            } else if (finishing) {
+                pendingConnections.remove(i);
+            } else {
+                i++;
+            }
+        }
+    }
+
+    void finish() {
+        stopTimer();
+        attachConnections(true);
+        project.loadProgress = 1.0;
+        // Leave the undo history alone if anything recorded undo steps during the load (e.g. a parameter edit).
+        if (!project.undoManager.canUndo()) {
+            if (const auto *focusedProcessor = project.tracks.getFocusedProcessor())
+                project.selectProcessor(focusedProcessor);
+            project.undoManager.clearUndoHistory();
+        }
+        project.sendChangeMessage();
+    }
+};
+
+void Project::finishLoading() {
+    // `finish` marks the load as done before selecting, so it doesn't end up back here.
+    if (streamingLoader != nullptr && isLoading()) streamingLoader->finishNow();
+}
+
 Project::~Project() {
+    streamingLoader = nullptr;
     undoManager.removeChangeListener(this);
 }
 
 void Project::loadFromState(const ValueTree &fromState) {
+    const BatchedUpdates::Scope batchedUpdates;
+    beginLoadFromState(fromState);
+    tracks.loadFromParentState(fromState);
+    processorGraph.addProcessors(allProcessors.getAllProcessors());
+    connections.loadFromParentState(fromState);
+    selectProcessor(tracks.getFocusedProcessor());
+    undoManager.clearUndoHistory();
+    sendChangeMessage();
+}
+
+void Project::loadFromStateStreaming(const ValueTree &fromState) {
+    const BatchedUpdates::Scope batchedUpdates;
+    beginLoadFromState(fromState);
+    loadProgress = 0.0;
+    streamingLoader = std::make_unique<StreamingLoader>(*this, fromState.getChildWithName(TracksIDs::TRACKS), fromState.getChildWithName(ConnectionsIDs::CONNECTIONS));
+    undoManager.clearUndoHistory();
+    sendChangeMessage();
+}
+
+void Project::beginLoadFromState(const ValueTree &fromState) {
     clear();
 
     view.loadFromParentState(fromState);
@@ -57,24 +185,21 @@ void Project::loadFromState(const ValueTree &fromState) {
                                                 "the best thing to do is to reconnect the missing device and "
                                                 "reload this project (without saving first!).");
 
-    if (isDeviceWithNamePresent(inputDeviceName))
+    if (headless || isDeviceWithNamePresent(inputDeviceName))
         input.loadFromParentState(fromState);
     else
         AlertWindow::showMessageBoxAsync(AlertWindow::WarningIcon, TRANS("Failed to open input device \"") + inputDeviceName + "\"", failureMessage);
 
-    if (isDeviceWithNamePresent(outputDeviceName))
+    if (headless || isDeviceWithNamePresent(outputDeviceName))
         output.loadFromParentState(fromState);
     else
         AlertWindow::showMessageBoxAsync(AlertWindow::WarningIcon, TRANS("Failed to open output device \"") + outputDeviceName + "\"", failureMessage);
-
-    tracks.loadFromParentState(fromState);
-    connections.loadFromParentState(fromState);
-    selectProcessor(tracks.getFocusedProcessor());
-    undoManager.clearUndoHistory();
-    sendChangeMessage();
 }
 
 void Project::clear() {
+    streamingLoader = nullptr;
+    loadProgress = 1.0;
+    processorGraph.removeProcessors(allProcessors.getAllProcessors());
     input.clear();
     output.clear();
     tracks.clear();
@@ -83,9 +208,11 @@ void Project::clear() {
 }
 
 void Project::createTrack(bool isMaster) {
+    finishLoading();
     if (isMaster && tracks.getMasterTrack() != nullptr) return; // only one master track allowed!
 
     setShiftHeld(false); // prevent rectangle-select behavior when doing cmd+shift+t
+    const BatchedUpdates::Scope batchedUpdates;
     undoManager.beginNewTransaction();
 
     undoManager.perform(new CreateTrack(isMaster, -1, tracks, view));
@@ -98,6 +225,8 @@ void Project::createTrack(bool isMaster) {
 }
 
 void Project::createProcessor(const PluginDescription &description, int slot) {
+    finishLoading();
+    const BatchedUpdates::Scope batchedUpdates;
     undoManager.beginNewTransaction();
     auto *focusedTrack = tracks.getFocusedTrack();
     if (focusedTrack != nullptr) {
@@ -106,9 +235,11 @@ void Project::createProcessor(const PluginDescription &description, int slot) {
 }
 
 void Project::deleteSelectedItems() {
+    finishLoading();
     if (isCurrentlyDraggingProcessor())
         endDraggingProcessor();
 
+    const BatchedUpdates::Scope batchedUpdates;
     undoManager.beginNewTransaction();
     undoManager.perform(new DeleteSelectedItems(tracks, connections, processorGraph));
     if (view.getFocusedTrackIndex() >= tracks.size() && tracks.size() > 0)
@@ -117,24 +248,29 @@ void Project::deleteSelectedItems() {
 }
 
 void Project::insert() {
+    finishLoading();
     if (isCurrentlyDraggingProcessor())
         endDraggingProcessor();
+    const BatchedUpdates::Scope batchedUpdates;
     undoManager.beginNewTransaction();
     undoManager.perform(new Insert(false, copiedTracks, view.getFocusedTrackAndSlot(), tracks, connections, view, input, allProcessors, processorGraph));
     updateAllDefaultConnections();
 }
 
 void Project::duplicateSelectedItems() {
+    finishLoading();
     if (isCurrentlyDraggingProcessor())
         endDraggingProcessor();
     OwnedArray<Track> duplicateTracks;
     tracks.copySelectedItemsInto(duplicateTracks, processorGraph.getProcessorWrappers());
+    const BatchedUpdates::Scope batchedUpdates;
     undoManager.beginNewTransaction();
     undoManager.perform(new Insert(true, duplicateTracks, view.getFocusedTrackAndSlot(), tracks, connections, view, input, allProcessors, processorGraph));
     updateAllDefaultConnections();
 }
 
 void Project::beginDragging(const juce::Point<int> trackAndSlot) {
+    finishLoading();
     if (trackAndSlot.x == Tracks::INVALID_TRACK_AND_SLOT.x) return;
 
     const auto *track = tracks.get(trackAndSlot.x);
@@ -155,6 +291,8 @@ void Project::dragToPosition(juce::Point<int> trackAndSlot) {
         trackAndSlot == Tracks::INVALID_TRACK_AND_SLOT)
         return;
 
+    // Moving undoes the previous move of this drag first, so batch the relayouts of both.
+    const BatchedUpdates::Scope batchedUpdates;
     if (currentlyDraggingTrackAndSlot == initialDraggingTrackAndSlot)
         undoManager.beginNewTransaction();
 
@@ -181,6 +319,7 @@ void Project::dragToPosition(juce::Point<int> trackAndSlot) {
 }
 
 void Project::setProcessorSlotSelected(Track *track, int slot, bool selected, bool deselectOthers) {
+    finishLoading();
     if (track == nullptr) return;
 
     Select *selectAction = nullptr;
@@ -209,17 +348,20 @@ void Project::selectProcessor(const Processor *processor) {
 }
 
 bool Project::disconnectCustom(Processor *processor) {
+    finishLoading();
     undoManager.beginNewTransaction();
     return processorGraph.doDisconnectNode(processor, all, false, true, true, true);
 }
 
 void Project::setDefaultConnectionsAllowed(Processor *processor, bool defaultConnectionsAllowed) {
+    finishLoading();
     undoManager.beginNewTransaction();
     undoManager.perform(new SetDefaultConnectionsAllowed(processor, defaultConnectionsAllowed, connections));
     undoManager.perform(new ResetDefaultExternalInputConnectionsAction(connections, tracks, input, allProcessors, processorGraph));
 }
 
 void Project::toggleProcessorBypass(Processor *processor) {
+    finishLoading();
     undoManager.beginNewTransaction();
     processor->setBypassed(!processor->isBypassed(), &undoManager);
 }
@@ -275,17 +417,33 @@ void Project::updateAllDefaultConnections() {
 }
 
 Result Project::loadDocument(const File &file) {
+    if (BinaryProjectFile::isBinaryProjectFile(file)) {
+        ValueTree newState;
+        const auto result = BinaryProjectFile::read(file, newState);
+        if (result.failed()) return result;
+        if (!newState.hasType(ProjectIDs::PROJECT))
+            return Result::fail(TRANS("Not a valid project file"));
+
+        loadDocumentState(newState);
+        return Result::ok();
+    }
+
     if (auto xml = std::unique_ptr<XmlElement>(XmlDocument::parse(file))) {
         const ValueTree &newState = ValueTree::fromXml(*xml);
         if (!newState.isValid() || !newState.hasType(ProjectIDs::PROJECT))
             return Result::fail(TRANS("Not a valid project file"));
 
-        loadFromState(newState);
+        loadDocumentState(newState);
         return Result::ok();
     }
     return Result::fail(TRANS("Not a valid XML file"));
 }
 
+void Project::loadDocumentState(const ValueTree &newState) {
+    if (streamingLoadEnabled && !headless) loadFromStateStreaming(newState);
+    else loadFromState(newState);
+}
+
 bool Project::isDeviceWithNamePresent(const String &deviceName) const {
     for (auto *deviceType : deviceManager.getAvailableDeviceTypes()) {
         // Input devices
@@ -303,6 +461,14 @@ bool Project::isDeviceWithNamePresent(const String &deviceName) const {
 }
 
 Result Project::saveDocument(const File &file) {
+    if (streamingLoader != nullptr && isLoading()) streamingLoader->finishNow();
+    if (file.hasFileExtension(getBinaryFilenameSuffix())) {
+        const auto &processorWrappers = processorGraph.getProcessorWrappers();
+        return BinaryProjectFile::write(state, [&processorWrappers](const ValueTree &processorState, MemoryBlock &pluginState) {
+            return processorWrappers.getProcessorStateInformation(processorState, pluginState);
+        }, file);
+    }
+
     for (const auto *track : tracks.getChildren())
         for (auto processorState : track->getProcessorLane()->getState())
             processorGraph.getProcessorWrappers().saveProcessorStateInformationToState(processorState);
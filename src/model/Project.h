@@ -8,6 +8,7 @@
 #include "model/Input.h"
 #include "model/Output.h"
 #include "PluginManager.h"
+#include "BatchedUpdates.h"
 #include "ProcessorGraph.h"
 
 namespace ProjectIDs {
@@ -26,9 +27,22 @@ struct Project : public Stateful<Project>, public FileBasedDocument, private Cha
     static Identifier getIdentifier() { return ProjectIDs::PROJECT; }
     // TODO change to .fgp (flowgrid project)
     static String getFilenameSuffix() { return ".smp"; }
+    // Projects saved with this suffix use the binary format (see `BinaryProjectFile`). Either format loads from any file name.
+    static String getBinaryFilenameSuffix() { return ".smpb"; }
 
     void createDefaultProject();
     void loadFromState(const ValueTree &fromState) override;
+    // Loads the IO processors, the master track and the connections between them right away, so audio can start,
+    // then attaches the other tracks (instantiating their plugins) one per message-loop iteration.
+    void loadFromStateStreaming(const ValueTree &fromState);
+    bool isLoading() const { return loadProgress < 1.0; }
+    // Load any tracks still streaming in right away. Every edit (and undo/redo) starts with this, since the loader
+    // adds tracks and connections without recording undo steps, which would shift the indices edits are undone by.
+    void finishLoading();
+    // From 0 to 1 during a streaming load, for a `ProgressBar`.
+    double &getLoadProgress() { return loadProgress; }
+    // Documents are loaded streaming unless headless or disabled.
+    void setStreamingLoadEnabled(bool enabled) { streamingLoadEnabled = enabled; }
 
     void clear() override;
 
@@ -41,11 +55,15 @@ struct Project : public Stateful<Project>, public FileBasedDocument, private Cha
     }
 
     void undo() {
+        finishLoading();
         if (isCurrentlyDraggingProcessor()) endDraggingProcessor();
+        const BatchedUpdates::Scope batchedUpdates;
         undoManager.undo();
     }
     void redo() {
+        finishLoading();
         if (isCurrentlyDraggingProcessor()) endDraggingProcessor();
+        const BatchedUpdates::Scope batchedUpdates;
         undoManager.redo();
     }
 
@@ -108,6 +126,11 @@ struct Project : public Stateful<Project>, public FileBasedDocument, private Cha
 
     PluginManager &getPluginManager() const { return pluginManager; }
 
+    // Headless projects (e.g. offline rendering) have no audio device to check IO processors against,
+    // and no UI to show device warnings on, so IO state is loaded as-is.
+    void setHeadless(bool headless) { this->headless = headless; }
+    bool isHeadless() const { return headless; }
+
     //==============================================================================================================
     void newDocument() {
         clear();
@@ -141,6 +164,12 @@ private:
     juce::Point<int> selectionStartTrackAndSlot = {0, 0};
 
     bool shiftHeld{false}, altHeld{false}, push2ShiftHeld{false};
+    bool headless{false};
+    bool streamingLoadEnabled{true};
+    double loadProgress{1.0};
+
+    struct StreamingLoader;
+    std::unique_ptr<StreamingLoader> streamingLoader;
 
     juce::Point<int> initialDraggingTrackAndSlot = Tracks::INVALID_TRACK_AND_SLOT,
             currentlyDraggingTrackAndSlot = Tracks::INVALID_TRACK_AND_SLOT;
@@ -148,6 +177,9 @@ private:
     OwnedArray<Track> copiedTracks;
 
     void doCreateAndAddProcessor(const PluginDescription &description, Track *track, int slot = -1);
+    // Clears the project and loads everything but tracks and connections.
+    void beginLoadFromState(const ValueTree &fromState);
+    void loadDocumentState(const ValueTree &newState);
 
     void changeListenerCallback(ChangeBroadcaster *source) override;
 
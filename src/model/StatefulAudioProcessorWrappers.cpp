@@ -13,13 +13,19 @@ ValueTree StatefulAudioProcessorWrappers::saveProcessorInformationToState(Proces
 }
 
 void StatefulAudioProcessorWrappers::saveProcessorStateInformationToState(ValueTree &processorState) const {
+    MemoryBlock memoryBlock;
+    if (getProcessorStateInformation(processorState, memoryBlock))
+        Processor::setProcessorState(processorState, memoryBlock.toBase64Encoding());
+}
+
+bool StatefulAudioProcessorWrappers::getProcessorStateInformation(const ValueTree &processorState, MemoryBlock &memoryBlock) const {
     if (auto *processorWrapper = getProcessorWrapperForState(processorState)) {
         if (auto *audioProcessor = processorWrapper->audioProcessor) {
-            MemoryBlock memoryBlock;
             audioProcessor->getStateInformation(memoryBlock);
-            Processor::setProcessorState(processorState, memoryBlock.toBase64Encoding());
+            return true;
         }
     }
+    return false;
 }
 
 ValueTree StatefulAudioProcessorWrappers::copyProcessor(ValueTree &fromProcessor) const {
@@ -29,9 +35,25 @@ ValueTree StatefulAudioProcessorWrappers::copyProcessor(ValueTree &fromProcessor
     return copiedProcessor;
 }
 
-bool StatefulAudioProcessorWrappers::flushAllParameterValuesToValueTree() {
-    for (auto &nodeIdAndProcessorWrapper : processorWrapperForNodeId)
-        if (nodeIdAndProcessorWrapper.second->flushParameterValuesToValueTree())
-            return true;
-    return false;
+int StatefulAudioProcessorWrappers::flushDirtyParameterValuesToValueTree(int maxBatchSize) {
+    if (dirtyParameters.overflowed.exchange(false))
+        for (auto &nodeIdAndProcessorWrapper : processorWrapperForNodeId)
+            nodeIdAndProcessorWrapper.second->flushParameterValuesToValueTree();
+
+    int batchSize = 0;
+    StatefulAudioProcessorWrapper::Parameter *parameter;
+    while (batchSize < maxBatchSize && dirtyParameters.queue.pop(parameter)) {
+        // Cleared before copying, so that a change racing with this one is queued again.
+        if (parameter->needsUpdate.exchange(false)) {
+            parameter->copyValueToValueTree();
+            parameter->setAttachedComponentValues(parameter->value);
+            batchSize++;
+        }
+    }
+
+    parameterFlushStats.backlog = int(dirtyParameters.queue.size());
+    parameterFlushStats.lastBatchSize = batchSize;
+    parameterFlushStats.maxBacklog = jmax(parameterFlushStats.maxBacklog, parameterFlushStats.backlog);
+    parameterFlushStats.numFlushed += batchSize;
+    return batchSize;
 }
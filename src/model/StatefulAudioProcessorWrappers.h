@@ -6,6 +6,11 @@
 #include "Processor.h"
 
 struct StatefulAudioProcessorWrappers {
+    struct ParameterFlushStats {
+        int backlog{0}, lastBatchSize{0}, maxBacklog{0};
+        int64 numFlushed{0}, numOverflows{0};
+    };
+
     unsigned long size() const { return processorWrapperForNodeId.size(); }
 
     StatefulAudioProcessorWrapper *getProcessorWrapperForNodeId(juce::AudioProcessorGraph::NodeID nodeId) const {
@@ -32,12 +37,31 @@ struct StatefulAudioProcessorWrappers {
     }
 
     void set(juce::AudioProcessorGraph::NodeID nodeId, std::unique_ptr<StatefulAudioProcessorWrapper> processorWrapper) { processorWrapperForNodeId[nodeId] = std::move(processorWrapper); }
-    void erase(juce::AudioProcessorGraph::NodeID nodeId) { processorWrapperForNodeId.erase(nodeId); }
+    void erase(juce::AudioProcessorGraph::NodeID nodeId) {
+        // The queue can't be left pointing at any of its parameters. The processor keeps rendering until it leaves
+        // the graph's render sequence, so its parameters are first stopped from queueing themselves again.
+        if (auto *processorWrapper = getProcessorWrapperForNodeId(nodeId))
+            processorWrapper->stopListeningToParameters();
+        flushDirtyParameterValuesToValueTree(std::numeric_limits<int>::max());
+        processorWrapperForNodeId.erase(nodeId);
+    }
     ValueTree saveProcessorInformationToState(Processor *processor) const;
     void saveProcessorStateInformationToState(ValueTree &processorState) const;
+    // Raw plugin state, as `saveProcessorStateInformationToState` saves it before encoding. Returns `false` if the processor isn't instantiated.
+    bool getProcessorStateInformation(const ValueTree &processorState, MemoryBlock &memoryBlock) const;
     ValueTree copyProcessor(ValueTree &fromProcessor) const;
-    bool flushAllParameterValuesToValueTree();
+    StatefulAudioProcessorWrapper::DirtyParameters &getDirtyParameters() { return dirtyParameters; }
+    // Copy up to `maxBatchSize` changed parameter values to their value trees. Returns the number copied.
+    int flushDirtyParameterValuesToValueTree(int maxBatchSize);
+    ParameterFlushStats getParameterFlushStats() const {
+        auto stats = parameterFlushStats;
+        stats.numOverflows = dirtyParameters.numOverflows.load(std::memory_order_relaxed);
+        return stats;
+    }
 
 private:
+    StatefulAudioProcessorWrapper::DirtyParameters dirtyParameters;
+    ParameterFlushStats parameterFlushStats;
+
     std::map<juce::AudioProcessorGraph::NodeID, std::unique_ptr<StatefulAudioProcessorWrapper> > processorWrapperForNodeId;
 };
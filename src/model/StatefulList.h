@@ -1,5 +1,7 @@
 #pragma once
 
+#include <unordered_map>
+
 #include <juce_core/juce_core.h>
 #include <juce_data_structures/juce_data_structures.h>
 #include "Stateful.h"
@@ -51,7 +53,10 @@ public:
     void removeChildListener(Listener *listener) { removeListener(listener); }
 
     int size() const noexcept { return children.size(); }
-    int indexOf(ObjectType *object) const { return children.indexOf(object); }
+    int indexOf(ObjectType *object) const {
+        const auto index = indexForChild.find(object);
+        return index != indexForChild.end() ? index->second : -1;
+    }
 
     ObjectType *get(int index) const noexcept { return children[index]; }
     const Array<ObjectType *> &getChildren() const { return children; }
@@ -65,11 +70,8 @@ public:
     ObjectType *getChildForState(const ValueTree &state) const {
         if (!state.isValid()) return nullptr;
 
-        for (int i = 0; i < children.size(); ++i) {
-            auto *child = children.getUnchecked(i);
-            if (child->getState() == state) return child;
-        }
-        return nullptr;
+        const auto child = childForState.find(state);
+        return child != childForState.end() ? child->second : nullptr;
     }
 
     int compareElements(ObjectType *first, ObjectType *second) const {
@@ -77,8 +79,16 @@ public:
     }
 
 protected:
+    // Trees sharing an object share their property set, so its address identifies the object.
+    struct StateHash {
+        size_t operator()(const ValueTree &state) const noexcept { return std::hash<const void *>()(&state.getProperties()); }
+    };
+
     ValueTree parent;
     Array<ObjectType *> children;
+    std::unordered_map<ValueTree, ObjectType *, StateHash> childForState;
+    // Index of each object in `children`, kept up to date with every insertion, removal and reordering.
+    std::unordered_map<const ObjectType *, int> indexForChild;
     ListenerList<Listener> listeners;
     ObjectType *mostRecentlyCreatedObject{};
 
@@ -102,6 +112,8 @@ protected:
             //  and have this trigger the same behavior in valueTreeChildRemoved?
             int oldIndex = children.size() - 1;
             ObjectType *o = children.removeAndReturn(oldIndex);
+            childForState.erase(o->getState());
+            indexForChild.erase(o);
             onChildRemoved(o, oldIndex);
             deleteChild(o);
         }
@@ -110,20 +122,33 @@ protected:
     bool isChildTree(ValueTree &tree) const { return isChildType(tree) && tree.getParent() == parent; }
 
     int indexOf(const ValueTree &tree) const noexcept {
-        for (int i = 0; i < children.size(); ++i)
-            if (children.getUnchecked(i)->getState() == tree)
-                return i;
-        return -1;
+        const auto child = childForState.find(tree);
+        return child != childForState.end() ? indexOf(child->second) : -1;
+    }
+
+    // Renumber the objects from `index` on, after objects were inserted or removed there.
+    void reindexFrom(int index) {
+        for (int i = index; i < children.size(); i++)
+            indexForChild[children.getUnchecked(i)] = i;
     }
 
     void valueTreeChildAdded(ValueTree &, ValueTree &tree) override {
         if (isChildTree(tree)) {
             const int index = parent.indexOf(tree);
             if (ObjectType *newObject = createNewObject(tree)) {
-                if (index == parent.getNumChildren() - 1)
+                if (children.isEmpty() || index == parent.getNumChildren() - 1 ||
+                    (index > 0 && parent.getChild(index - 1) == children.getLast()->getState())) {
                     children.add(newObject);
-                else
-                    children.addSorted(*this, newObject);
+                    indexForChild[newObject] = children.size() - 1;
+                } else {
+                    // Insert after the objects of all earlier sibling trees.
+                    int childIndex = 0;
+                    for (int i = 0; i < index; i++)
+                        if (childForState.count(parent.getChild(i)) > 0) childIndex++;
+                    children.insert(childIndex, newObject);
+                    reindexFrom(childIndex);
+                }
+                childForState[newObject->getState()] = newObject;
                 mostRecentlyCreatedObject = newObject;
                 onChildAdded(newObject);
                 listeners.call(&Listener::onChildAdded, newObject);
@@ -136,6 +161,9 @@ protected:
             const int oldIndex = indexOf(tree);
             if (oldIndex >= 0) {
                 auto *child = children.removeAndReturn(oldIndex);
+                childForState.erase(tree);
+                indexForChild.erase(child);
+                reindexFrom(oldIndex);
                 listeners.call(&Listener::onChildRemoved, child, oldIndex);
                 // Not correct but doesn't leave dangling pointers
                 // TODO queue
@@ -148,7 +176,15 @@ protected:
 
     void valueTreeChildOrderChanged(ValueTree &tree, int, int) override {
         if (tree == parent) {
-            children.sort(*this);
+            // Rebuild in tree order, rather than sorting with a tree search per comparison.
+            Array<ObjectType *> sortedChildren;
+            sortedChildren.ensureStorageAllocated(children.size());
+            for (const auto &childState : parent) {
+                const auto child = childForState.find(childState);
+                if (child != childForState.end()) sortedChildren.add(child->second);
+            }
+            children.swapWith(sortedChildren);
+            reindexFrom(0);
             onOrderChanged();
             listeners.call(&Listener::onOrderChanged);
         }
@@ -23,45 +23,74 @@ public:
     void prepareToPlay(double sampleRate, int samplesPerBlock) override {
         ignoreUnused(samplesPerBlock);
 
-        notes.clear();
+        numNotes = 0;
+        generatedMidi.ensureSize(MIDI_BUFFER_SIZE);
         currentNote = 0;
         lastNoteValue = -1;
         time = 0;
         rate = static_cast<float> (sampleRate);
     }
 
-    void processBlock(AudioBuffer<float> &buffer, MidiBuffer &midi) override {
+    void processAudioBlock(AudioBuffer<float> &buffer, MidiBuffer &midi) override {
         auto numSamples = buffer.getNumSamples();
         auto noteDuration = static_cast<int> (std::ceil(rate * 0.25f * (0.1f + (1.0f - (*speed)))));
 
         for (const auto metadata : midi) {
             const auto msg = metadata.getMessage();
-            if (msg.isNoteOn()) notes.add(msg.getNoteNumber());
-            else if (msg.isNoteOff()) notes.removeValue(msg.getNoteNumber());
+            if (msg.isNoteOn()) addNote(msg.getNoteNumber());
+            else if (msg.isNoteOff()) removeNote(msg.getNoteNumber());
         }
 
-        midi.clear();
+        generatedMidi.clear();
 
         if ((time + numSamples) >= noteDuration) {
             auto offset = jmax(0, jmin((int) (noteDuration - time), numSamples - 1));
             if (lastNoteValue > 0) {
-                midi.addEvent(MidiMessage::noteOff(1, lastNoteValue), offset);
+                generatedMidi.addEvent(MidiMessage::noteOff(1, lastNoteValue), offset);
                 lastNoteValue = -1;
             }
-            if (notes.size() > 0) {
-                currentNote = (currentNote + 1) % notes.size();
-                lastNoteValue = notes[currentNote];
-                midi.addEvent(MidiMessage::noteOn(1, lastNoteValue, (uint8) 127), offset);
+            if (numNotes > 0) {
+                currentNote = (currentNote + 1) % numNotes;
+                lastNoteValue = notes[size_t(currentNote)];
+                generatedMidi.addEvent(MidiMessage::noteOn(1, lastNoteValue, (uint8) 127), offset);
             }
         }
+        // Copied rather than swapped, so that both buffers keep their own storage. Both renderers preallocate the buffer
+        // they pass in, and this only ever adds a couple of events to it.
+        midi.clear();
+        midi.addEvents(generatedMidi, 0, numSamples, 0);
 
         time = (time + numSamples) % noteDuration;
     }
 
 private:
+    static constexpr int MIDI_BUFFER_SIZE = 256;
+
     AudioParameterFloat *speed;
     int currentNote{0}, lastNoteValue{0};
     int time{0};
     float rate{0};
-    SortedSet<int> notes;
+    // Held note numbers in ascending order. There are only 128, so this never needs to grow.
+    std::array<int, 128> notes{};
+    int numNotes{0};
+    MidiBuffer generatedMidi;
+
+    void addNote(int noteNumber) {
+        const auto end = notes.begin() + numNotes;
+        const auto position = std::lower_bound(notes.begin(), end, noteNumber);
+        if (position != end && *position == noteNumber) return;
+
+        std::move_backward(position, end, end + 1);
+        *position = noteNumber;
+        numNotes++;
+    }
+
+    void removeNote(int noteNumber) {
+        const auto end = notes.begin() + numNotes;
+        const auto position = std::lower_bound(notes.begin(), end, noteNumber);
+        if (position == end || *position != noteNumber) return;
+
+        std::move(position + 1, end, position);
+        numNotes--;
+    }
 };
@@ -1,12 +1,13 @@
 #pragma once
 
 #include "DefaultAudioProcessor.h"
+#include "StereoBalanceGain.h"
 
 class BalanceProcessor : public DefaultAudioProcessor {
 public:
     explicit BalanceProcessor() :
             DefaultAudioProcessor(getPluginDescription()),
-            balanceParameter(new AudioParameterFloat("balance", "Balance", NormalisableRange<float>(-1.0f, 1.0f), balance.getTargetValue(), "",
+            balanceParameter(new AudioParameterFloat("balance", "Balance", NormalisableRange<float>(-1.0f, 1.0f), balanceGain.getBalance(), "",
                                                      AudioProcessorParameter::genericParameter, defaultStringFromValue, defaultValueFromString)) {
         balanceParameter->addListener(this);
         addParameter(balanceParameter);
@@ -23,38 +24,20 @@ public:
     }
 
     void prepareToPlay(double sampleRate, int maximumExpectedSamplesPerBlock) override {
-        balance.reset(getSampleRate(), 0.05);
+        balanceGain.prepare(getSampleRate(), maximumExpectedSamplesPerBlock);
     }
 
     void parameterChanged(AudioProcessorParameter *parameter, float newValue) override {
         if (parameter == balanceParameter) {
-            balance.setTargetValue(newValue);
+            balanceGain.setBalance(newValue);
         }
     }
 
-    void processBlock(AudioSampleBuffer &buffer, MidiBuffer &midiMessages) override {
-        if (buffer.getNumChannels() == 2) {
-            // 0db at center, linear stereo balance control
-            // http://www.kvraudio.com/forum/viewtopic.php?t=148865
-            for (int i = 0; i < buffer.getNumSamples(); i++) {
-                const float balanceValue = balance.getNextValue();
-
-                float leftChannelGain, rightChannelGain;
-                if (balanceValue < 0.0) {
-                    leftChannelGain = 1;
-                    rightChannelGain = 1 + balanceValue;
-                } else {
-                    leftChannelGain = 1 - balanceValue;
-                    rightChannelGain = 1;
-                }
-
-                buffer.setSample(0, i, buffer.getSample(0, i) * leftChannelGain);
-                buffer.setSample(1, i, buffer.getSample(1, i) * rightChannelGain);
-            }
-        }
+    void processAudioBlock(AudioSampleBuffer &buffer, MidiBuffer &midiMessages) override {
+        balanceGain.process(buffer);
     }
 
 private:
-    LinearSmoothedValue<float> balance{0.0f};
+    StereoBalanceGain balanceGain{false};
     AudioParameterFloat *balanceParameter;
 };
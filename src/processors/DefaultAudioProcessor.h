@@ -2,6 +2,8 @@
 
 #include <juce_audio_processors/juce_audio_processors.h>
 #include "view/parameter_control/level_meter/LevelMeterSource.h"
+#include "ProcessorTimingStats.h"
+#include "AudioThreadChecker.h"
 #include "FlowGridConfig.h"
 
 using namespace juce;
@@ -31,6 +33,17 @@ public:
 
     void parameterGestureChanged(int parameterIndex, bool gestureIsStarting) override {}
 
+    // Subclasses implement `processAudioBlock` instead, so that every internal processor can be profiled.
+    void processBlock(AudioSampleBuffer &buffer, MidiBuffer &midiMessages) final {
+        const AudioThreadChecker::Scope checkerScope(this);
+        timer.time(buffer.getNumSamples(), [&] { processAudioBlock(buffer, midiMessages); });
+    }
+
+    virtual void processAudioBlock(AudioSampleBuffer &buffer, MidiBuffer &midiMessages) = 0;
+
+    // Third-party plugins are timed by a `ProfiledPluginInstance` around them instead.
+    ProcessorTimer &getTimer() { return timer; }
+
     virtual LevelMeterSource *getMeterSource() { return nullptr; }
 
     virtual AudioProcessorParameter *getMeteredParameter() { return nullptr; } // TODO should be a new MeteredParameter type
@@ -81,4 +94,5 @@ private:
     String name, state;
     bool isGenerator, hasMidi;
     AudioChannelSet channelSet;
+    ProcessorTimer timer;
 };
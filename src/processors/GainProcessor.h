@@ -31,7 +31,7 @@ public:
         }
     }
 
-    void processBlock(AudioSampleBuffer &buffer, MidiBuffer &midiMessages) override {
+    void processAudioBlock(AudioSampleBuffer &buffer, MidiBuffer &midiMessages) override {
         gain.applyGain(buffer, buffer.getNumSamples());
     }
 
@@ -39,7 +39,7 @@ InternalPluginFormat::InternalPluginFormat() : internalPluginDescriptions{
     internalPluginDescriptions.add(audioInDesc, audioOutDesc);
 }
 
-std::unique_ptr<AudioPluginInstance> InternalPluginFormat::createInstance(const String &name) const {
+std::unique_ptr<AudioPluginInstance> InternalPluginFormat::createInstance(const String &name, const String &options) const {
     if (name == audioOutDesc.name) return std::make_unique<AudioProcessorGraph::AudioGraphIOProcessor>(AudioProcessorGraph::AudioGraphIOProcessor::audioOutputNode);
     if (name == audioInDesc.name) return std::make_unique<AudioProcessorGraph::AudioGraphIOProcessor>(AudioProcessorGraph::AudioGraphIOProcessor::audioInputNode);
     if (name == TrackInputProcessor::name()) return std::make_unique<TrackInputProcessor>();
@@ -52,7 +52,7 @@ std::unique_ptr<AudioPluginInstance> InternalPluginFormat::createInstance(const
     if (name == GainProcessor::name()) return std::make_unique<GainProcessor>();
     if (name == MixerChannelProcessor::name()) return std::make_unique<MixerChannelProcessor>();
     if (name == ParameterTypesTestProcessor::name()) return std::make_unique<ParameterTypesTestProcessor>();
-    if (name == SineBank::name()) return std::make_unique<SineBank>();
+    if (name == SineBank::name()) return std::make_unique<SineBank>(SineBank::getNumPartials(options));
     if (name == SineSynth::name()) return std::make_unique<SineSynth>();
 
     return {};
@@ -93,7 +93,7 @@ String InternalPluginFormat::getMidiOutputProcessorName() { return MidiOutputPro
 String InternalPluginFormat::getMixerChannelProcessorName() { return MixerChannelProcessor::name(); }
 
 void InternalPluginFormat::createPluginInstance(const PluginDescription &desc, double initialSampleRate, int initialBufferSize, AudioPluginFormat::PluginCreationCallback callback) {
-    if (auto pluginInstance = createInstance(desc.name))
+    if (auto pluginInstance = createInstance(desc.name, desc.fileOrIdentifier.fromFirstOccurrenceOf(":", false, false)))
         callback(std::move(pluginInstance), {});
     else
         callback(nullptr, NEEDS_TRANS("Invalid internal plugin name"));
@@ -10,7 +10,8 @@ public:
 
     PluginDescription audioInDesc, audioOutDesc;
 
-    String getName() const override { return "Internal"; }
+    static String getFormatName() { return "Internal"; }
+    String getName() const override { return getFormatName(); }
     Array<PluginDescription> &getInternalPluginDescriptions() { return internalPluginDescriptions; }
     bool fileMightContainThisPluginType(const String &) override { return true; }
     FileSearchPath getDefaultLocationsToSearch() override { return {}; }
@@ -37,7 +38,8 @@ private:
     Array<PluginDescription> internalPluginDescriptions;
 
     void createPluginInstance(const PluginDescription &desc, double initialSampleRate, int initialBufferSize, PluginCreationCallback callback) override;
-    std::unique_ptr<AudioPluginInstance> createInstance(const String &name) const;
+    // `options` are what follows the ':' in the description's `fileOrIdentifier`.
+    std::unique_ptr<AudioPluginInstance> createInstance(const String &name, const String &options = {}) const;
 
     bool requiresUnblockedMessageThreadDuringCreation(const PluginDescription &) const noexcept override { return false; }
 };
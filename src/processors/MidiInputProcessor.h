@@ -26,7 +26,7 @@ public:
         messageCollector.reset(sampleRate);
     }
 
-    void processBlock(AudioSampleBuffer &buffer, MidiBuffer &midiMessages) override {
+    void processAudioBlock(AudioSampleBuffer &buffer, MidiBuffer &midiMessages) override {
         messageCollector.removeNextBlockOfMessages(midiMessages, buffer.getNumSamples());
     }
 
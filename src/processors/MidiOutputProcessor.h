@@ -25,7 +25,7 @@ public:
 
     void prepareToPlay(double sampleRate, int maximumExpectedSamplesPerBlock) override {}
 
-    void processBlock(AudioSampleBuffer &buffer, MidiBuffer &midiMessages) override {
+    void processAudioBlock(AudioSampleBuffer &buffer, MidiBuffer &midiMessages) override {
         if (midiOutput != nullptr) {
             midiOutput->sendBlockOfMessagesNow(midiMessages);
         }
@@ -1,13 +1,14 @@
 #pragma once
 
 #include "DefaultAudioProcessor.h"
+#include "StereoBalanceGain.h"
 #include "view/parameter_control/level_meter/LevelMeter.h"
 
 class MixerChannelProcessor : public DefaultAudioProcessor {
 public:
     explicit MixerChannelProcessor() :
             DefaultAudioProcessor(getPluginDescription()),
-            balanceParameter(new AudioParameterFloat("balance", "Balance", NormalisableRange<float>(-1.0f, 1.0f), balance.getTargetValue(), "",
+            balanceParameter(new AudioParameterFloat("balance", "Balance", NormalisableRange<float>(-1.0f, 1.0f), balanceGain.getBalance(), "",
                                                      AudioProcessorParameter::genericParameter, defaultStringFromValue, defaultValueFromString)),
             gainParameter(createDefaultGainParameter("gain", "Gain")) {
         balanceParameter->addListener(this);
@@ -29,39 +30,20 @@ public:
     }
 
     void prepareToPlay(double sampleRate, int maximumExpectedSamplesPerBlock) override {
-        balance.reset(getSampleRate(), 0.05);
-        gain.reset(getSampleRate(), 0.05);
+        balanceGain.prepare(getSampleRate(), maximumExpectedSamplesPerBlock);
+        meterSource.prepare(getTotalNumOutputChannels(), sampleRate);
     }
 
     void parameterChanged(AudioProcessorParameter *parameter, float newValue) override {
         if (parameter == balanceParameter) {
-            balance.setTargetValue(newValue);
+            balanceGain.setBalance(newValue);
         } else if (parameter == gainParameter) {
-            gain.setTargetValue(Decibels::decibelsToGain(newValue));
+            balanceGain.setGain(Decibels::decibelsToGain(newValue));
         }
     }
 
-    void processBlock(AudioSampleBuffer &buffer, MidiBuffer &midiMessages) override {
-        if (buffer.getNumChannels() == 2) {
-            // 0db at center, linear stereo balance control
-            // http://www.kvraudio.com/forum/viewtopic.php?t=148865
-            for (int i = 0; i < buffer.getNumSamples(); i++) {
-                const float balanceValue = balance.getNextValue();
-
-                float leftChannelGain, rightChannelGain;
-                if (balanceValue < 0.0) {
-                    leftChannelGain = 1;
-                    rightChannelGain = 1 + balanceValue;
-                } else {
-                    leftChannelGain = 1 - balanceValue;
-                    rightChannelGain = 1;
-                }
-
-                buffer.setSample(0, i, buffer.getSample(0, i) * leftChannelGain);
-                buffer.setSample(1, i, buffer.getSample(1, i) * rightChannelGain);
-            }
-        }
-        gain.applyGain(buffer, buffer.getNumSamples());
+    void processAudioBlock(AudioSampleBuffer &buffer, MidiBuffer &midiMessages) override {
+        balanceGain.process(buffer);
         meterSource.measureBlock(buffer);
     }
 
@@ -69,8 +51,7 @@ public:
     AudioProcessorParameter *getMeteredParameter() override { return gainParameter; }
 
 private:
-    LinearSmoothedValue<float> balance{0.0};
-    LinearSmoothedValue<float> gain{Decibels::decibelsToGain(0.0f)};
+    StereoBalanceGain balanceGain;
 
     AudioParameterFloat *balanceParameter;
     AudioParameterFloat *gainParameter;
@@ -0,0 +1,157 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include <juce_audio_basics/juce_audio_basics.h>
+
+using namespace juce;
+
+/*!
+ *  Bank of sine partials, each with its own smoothed amplitude and frequency, summed into one output.
+ *
+ *  Each partial is a recursive rotation oscillator: a unit phasor rotated by its per-sample phase increment,
+ *  so each sample takes four multiplies and no trig.
+ *  Partial state is kept as structures of arrays, and partials are processed `LANES` at a time in fixed-width loops
+ *  the compiler maps onto SIMD lanes. Each group accumulates into a lane-wide mix per sample,
+ *  which is only summed across lanes once per sample, after all groups are done.
+ *
+ *  Frequencies are smoothed at block rate: each partial's rotation is only recomputed for blocks where its frequency moved.
+ *  Amplitudes ramp linearly across each block. Phasors are renormalized once per block, so their magnitude doesn't drift.
+ *  Partials at or above Nyquist fade out.
+ *
+ *  The targets can be set from any thread. `setNumPartials` and `prepare` allocate, and `process` never does.
+ */
+struct OscillatorBank {
+    static constexpr int LANES = 8;
+
+    explicit OscillatorBank(int numPartials = 0) { setNumPartials(numPartials); }
+
+    // Not thread-safe. Call before `prepare`.
+    void setNumPartials(int numPartials) {
+        this->numPartials = jmax(0, numPartials);
+        targetFrequencies = std::make_unique<std::atomic<float>[]>(size_t(this->numPartials));
+        targetAmplitudes = std::make_unique<std::atomic<float>[]>(size_t(this->numPartials));
+
+        // Padded to a whole number of lane groups. Padding partials stay silent.
+        const auto numPaddedPartials = size_t((this->numPartials + LANES - 1) / LANES * LANES);
+        for (auto *partialState : {&xs, &ys, &increments, &cosines, &sines, &amplitudes})
+            partialState->assign(numPaddedPartials, 0.0f);
+    }
+
+    int getNumPartials() const { return numPartials; }
+
+    void setFrequency(int partial, float frequency) { targetFrequencies[size_t(partial)].store(frequency, std::memory_order_relaxed); }
+    void setAmplitude(int partial, float gain) { targetAmplitudes[size_t(partial)].store(gain, std::memory_order_relaxed); }
+
+    // Resets every partial to the start of its cycle, at its target frequency and amplitude.
+    void prepare(double sampleRate, int maximumBlockSize) {
+        this->sampleRate = sampleRate;
+        mix.assign(size_t(jmax(1, maximumBlockSize) * LANES), 0.0f);
+
+        for (int partial = 0; partial < numPartials; ++partial) {
+            const auto index = size_t(partial);
+            xs[index] = 1.0f;
+            ys[index] = 0.0f;
+            increments[index] = getTargetIncrement(partial);
+            cosines[index] = std::cos(increments[index]);
+            sines[index] = std::sin(increments[index]);
+            amplitudes[index] = getTargetAmplitude(partial);
+        }
+    }
+
+    // Overwrites `output` with the sum of all partials.
+    void process(float *output, int numSamples) {
+        const int maxChunkSize = int(mix.size()) / LANES;
+        if (maxChunkSize == 0) return FloatVectorOperations::clear(output, numSamples); // Not prepared
+        for (int start = 0; start < numSamples; start += maxChunkSize)
+            processChunk(output + start, jmin(maxChunkSize, numSamples - start));
+    }
+
+private:
+    static constexpr double SMOOTHING_SECONDS = 0.05;
+
+    int numPartials{0};
+    double sampleRate{44100.0};
+    std::unique_ptr<std::atomic<float>[]> targetFrequencies, targetAmplitudes;
+    // Audio thread only, one entry per (padded) partial.
+    std::vector<float> xs, ys, increments, cosines, sines, amplitudes;
+    // `LANES` partial sums per sample.
+    std::vector<float> mix;
+
+    float getTargetIncrement(int partial) const {
+        const auto frequency = jlimit(0.0, sampleRate / 2.0, double(targetFrequencies[size_t(partial)].load(std::memory_order_relaxed)));
+        return float(MathConstants<double>::twoPi * frequency / sampleRate);
+    }
+
+    float getTargetAmplitude(int partial) const {
+        const auto frequency = double(targetFrequencies[size_t(partial)].load(std::memory_order_relaxed));
+        return frequency < sampleRate / 2.0 ? targetAmplitudes[size_t(partial)].load(std::memory_order_relaxed) : 0.0f;
+    }
+
+    void processChunk(float *output, int numSamples) {
+        std::fill(mix.begin(), mix.begin() + numSamples * LANES, 0.0f);
+        // The share of the distance to each target covered in this block.
+        const auto smoothing = float(1.0 - std::exp(-double(numSamples) / (SMOOTHING_SECONDS * sampleRate)));
+
+        for (int first = 0; first < numPartials; first += LANES) {
+            float x[LANES], y[LANES], c[LANES], s[LANES], amplitude[LANES], amplitudeStep[LANES];
+            for (int lane = 0; lane < LANES; ++lane) {
+                const auto partial = first + lane;
+                const auto index = size_t(partial);
+                amplitude[lane] = amplitudes[index];
+                amplitudeStep[lane] = partial < numPartials ? updateTargets(partial, smoothing, numSamples) : 0.0f;
+                x[lane] = xs[index];
+                y[lane] = ys[index];
+                c[lane] = cosines[index];
+                s[lane] = sines[index];
+            }
+
+            for (int i = 0; i < numSamples; ++i) {
+                float *mixLanes = mix.data() + i * LANES;
+                for (int lane = 0; lane < LANES; ++lane) {
+                    const float nextX = x[lane] * c[lane] - y[lane] * s[lane];
+                    y[lane] = x[lane] * s[lane] + y[lane] * c[lane];
+                    x[lane] = nextX;
+                    amplitude[lane] += amplitudeStep[lane];
+                    mixLanes[lane] += amplitude[lane] * y[lane];
+                }
+            }
+
+            for (int lane = 0; lane < LANES; ++lane) {
+                // First-order correction of the phasor's magnitude back to 1.
+                const float gain = 0.5f * (3.0f - (x[lane] * x[lane] + y[lane] * y[lane]));
+                xs[size_t(first + lane)] = x[lane] * gain;
+                ys[size_t(first + lane)] = y[lane] * gain;
+            }
+        }
+
+        for (int i = 0; i < numSamples; ++i) {
+            const float *mixLanes = mix.data() + i * LANES;
+            float sum = 0.0f;
+            for (int lane = 0; lane < LANES; ++lane) sum += mixLanes[lane];
+            output[i] = sum;
+        }
+    }
+
+    // Moves the partial's frequency (for the whole block) and amplitude (by the end of the block) toward their targets.
+    // Returns the per-sample amplitude step.
+    float updateTargets(int partial, float smoothing, int numSamples) {
+        const auto index = size_t(partial);
+        const float targetIncrement = getTargetIncrement(partial);
+        if (increments[index] != targetIncrement) {
+            const float difference = targetIncrement - increments[index];
+            // Snap once the remaining difference is inaudible, so the rotation stops being recomputed.
+            increments[index] = std::abs(difference) < 1.0e-7f ? targetIncrement : increments[index] + difference * smoothing;
+            cosines[index] = std::cos(increments[index]);
+            sines[index] = std::sin(increments[index]);
+        }
+
+        const float targetAmplitude = getTargetAmplitude(partial);
+        const float endAmplitude = amplitudes[index] + (targetAmplitude - amplitudes[index]) * smoothing;
+        const float amplitudeStep = (endAmplitude - amplitudes[index]) / float(numSamples);
+        amplitudes[index] = endAmplitude;
+        return amplitudeStep;
+    }
+};
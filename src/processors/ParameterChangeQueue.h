@@ -0,0 +1,81 @@
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+
+#include "MpscQueue.h"
+
+using namespace juce;
+
+/*!
+ *  Lock-free queue of parameter changes headed for the audio thread.
+ *  Changes are posted from any thread, and applied in order at the start of the next block of the owning graph.
+ *  Applying a change sets the parameter and notifies its processor (if it listens to its own parameters),
+ *  so processors update their DSP state between blocks. Other listeners aren't notified from here.
+ *
+ *  While nothing is draining the queue (no audio device running), or if it fills up, posting falls back
+ *  to applying the queued changes directly, under the graph's callback lock.
+ */
+struct ParameterChangeQueue {
+    explicit ParameterChangeQueue(AudioProcessor &graph) : graph(graph) {}
+
+    // `numPending`, if given, counts this change until it's been applied (or discarded).
+    void post(AudioProcessor *processor, AudioProcessorParameter *parameter, float normalizedValue, std::atomic<int> *numPending = nullptr) {
+        if (numPending != nullptr) numPending->fetch_add(1, std::memory_order_relaxed);
+        const Change change{processor, dynamic_cast<AudioProcessorParameter::Listener *>(processor), parameter, normalizedValue, numPending};
+        if (isBeingDrained() && changes.push(change)) return;
+
+        const ScopedLock lock(graph.getCallbackLock());
+        applyQueuedChanges(); // So nothing older can overwrite this value later
+        apply(change);
+    }
+
+    // Called on the audio thread at the start of each block.
+    void applyPendingChanges() noexcept {
+        applyQueuedChanges();
+        lastDrainTicks.store(Time::getHighResolutionTicks(), std::memory_order_relaxed);
+    }
+
+    // Call before the processor is deleted. Any of its changes still queued are dropped, and all others are applied.
+    void discardChangesForProcessor(const AudioProcessor *processor) {
+        const ScopedLock lock(graph.getCallbackLock());
+        Change change;
+        while (changes.pop(change)) {
+            if (change.processor != processor) apply(change);
+            else if (change.numPending != nullptr) change.numPending->fetch_sub(1, std::memory_order_release);
+        }
+    }
+
+private:
+    struct Change {
+        const AudioProcessor *processor{};
+        AudioProcessorParameter::Listener *processorListener{};
+        AudioProcessorParameter *parameter{};
+        float value{0};
+        std::atomic<int> *numPending{};
+    };
+
+    AudioProcessor &graph;
+    MpscQueue<Change, 4096> changes;
+    std::atomic<int64> lastDrainTicks{0};
+
+    // Only the audio thread stamps `lastDrainTicks`, so the fallback in `post` never makes the queue look drained.
+    void applyQueuedChanges() noexcept {
+        Change change;
+        while (changes.pop(change))
+            apply(change);
+    }
+
+    static void apply(const Change &change) noexcept {
+        if (change.parameter != nullptr) {
+            change.parameter->setValue(change.value);
+            if (change.processorListener != nullptr)
+                change.processorListener->parameterValueChanged(change.parameter->getParameterIndex(), change.value);
+        }
+        if (change.numPending != nullptr) change.numPending->fetch_sub(1, std::memory_order_release);
+    }
+
+    // Blocks are at most a few hundred milliseconds long. Anything beyond that means the graph isn't being processed.
+    bool isBeingDrained() const {
+        return Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - lastDrainTicks.load(std::memory_order_relaxed)) < 0.5;
+    }
+};
@@ -29,7 +29,7 @@ public:
 
     static PluginDescription getPluginDescription() { return DefaultAudioProcessor::getPluginDescription(name(), false, false); }
 
-    void processBlock(AudioSampleBuffer &buffer, MidiBuffer &midiMessages) override {}
+    void processAudioBlock(AudioSampleBuffer &buffer, MidiBuffer &midiMessages) override {}
 
 private:
     AudioParameterBool *boolParameter;
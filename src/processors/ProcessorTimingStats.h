@@ -0,0 +1,133 @@
+#pragma once
+
+#include <atomic>
+#include <array>
+#include <bit>
+
+#include <juce_core/juce_core.h>
+
+using namespace juce;
+
+/*!
+ *  Lock-free `processBlock` timing counters for a single processor.
+ *  `record` is only ever called from the thread running the processor (the audio thread),
+ *  and `getSnapshot` can be called from any other thread (the GUI).
+ *
+ *  Block durations are bucketed into a log-scale histogram with four buckets per octave,
+ *  so percentiles are accurate to within ~19%.
+ */
+struct ProcessorTimingStats {
+    struct Snapshot {
+        int64 numBlocks{0};
+        double minMicros{0}, meanMicros{0}, p99Micros{0};
+        // Fraction of the real-time budget (the duration of the audio in the processed blocks) spent processing.
+        double budgetShare{0};
+    };
+
+    static int64 getTicks() noexcept { return Time::getHighResolutionTicks(); }
+
+    void record(int64 startTicks, int numSamples) noexcept {
+        if (resetRequested.exchange(false, std::memory_order_acquire)) reset();
+
+        const auto nanos = static_cast<int64>(Time::highResolutionTicksToSeconds(getTicks() - startTicks) * 1.0e9);
+        numBlocks.store(numBlocks.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        totalNanos.store(totalNanos.load(std::memory_order_relaxed) + nanos, std::memory_order_relaxed);
+        totalSamples.store(totalSamples.load(std::memory_order_relaxed) + numSamples, std::memory_order_relaxed);
+        if (nanos < minNanos.load(std::memory_order_relaxed))
+            minNanos.store(nanos, std::memory_order_relaxed);
+        auto &bucket = buckets[static_cast<size_t>(bucketIndexForNanos(nanos))];
+        bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    Snapshot getSnapshot(double sampleRate) const {
+        Snapshot snapshot;
+        if (resetRequested.load(std::memory_order_relaxed)) return snapshot;
+
+        snapshot.numBlocks = numBlocks.load(std::memory_order_relaxed);
+        if (snapshot.numBlocks == 0) return snapshot;
+
+        const auto nanos = double(totalNanos.load(std::memory_order_relaxed));
+        snapshot.minMicros = double(minNanos.load(std::memory_order_relaxed)) / 1000.0;
+        snapshot.meanMicros = nanos / 1000.0 / double(snapshot.numBlocks);
+        if (sampleRate > 0) {
+            const auto budgetNanos = double(totalSamples.load(std::memory_order_relaxed)) / sampleRate * 1.0e9;
+            snapshot.budgetShare = budgetNanos > 0 ? nanos / budgetNanos : 0;
+        }
+
+        std::array<int64, NUM_BUCKETS> counts{};
+        int64 totalCount = 0;
+        for (size_t i = 0; i < counts.size(); i++)
+            totalCount += (counts[i] = buckets[i].load(std::memory_order_relaxed));
+        const auto p99Count = totalCount - totalCount / 100;
+        int64 count = 0;
+        for (int i = 0; i < NUM_BUCKETS; i++) {
+            count += counts[static_cast<size_t>(i)];
+            if (count >= p99Count) {
+                snapshot.p99Micros = double(upperBoundNanosForBucketIndex(i)) / 1000.0;
+                break;
+            }
+        }
+        return snapshot;
+    }
+
+    // Any thread. The counters are cleared by the next `record`, so they only ever have one writer.
+    void requestReset() noexcept { resetRequested.store(true, std::memory_order_release); }
+
+private:
+    static constexpr int SUB_BUCKETS_PER_OCTAVE = 4;
+    static constexpr int NUM_BUCKETS = 40 * SUB_BUCKETS_PER_OCTAVE;
+
+    // Octave from the highest set bit, sub-bucket from the next two bits.
+    static int bucketIndexForNanos(int64 nanos) noexcept {
+        if (nanos < SUB_BUCKETS_PER_OCTAVE) return 0;
+        const auto value = static_cast<uint64>(nanos);
+        const int highestBit = static_cast<int>(std::bit_width(value)) - 1;
+        const auto subBucket = static_cast<int>((value >> (highestBit - 2)) & 3);
+        return jmin(NUM_BUCKETS - 1, (highestBit - 1) * SUB_BUCKETS_PER_OCTAVE + subBucket);
+    }
+
+    static int64 upperBoundNanosForBucketIndex(int index) noexcept {
+        if (index < SUB_BUCKETS_PER_OCTAVE) return SUB_BUCKETS_PER_OCTAVE;
+
+        const int highestBit = index / SUB_BUCKETS_PER_OCTAVE + 1;
+        const int subBucket = index % SUB_BUCKETS_PER_OCTAVE;
+        return (int64(SUB_BUCKETS_PER_OCTAVE + subBucket + 1) << (highestBit - 2));
+    }
+
+    std::atomic<int64> numBlocks{0}, totalNanos{0}, totalSamples{0};
+    std::atomic<int64> minNanos{std::numeric_limits<int64>::max()};
+    std::array<std::atomic<int64>, NUM_BUCKETS> buckets{};
+    std::atomic<bool> resetRequested{false};
+
+    void reset() noexcept {
+        numBlocks.store(0, std::memory_order_relaxed);
+        totalNanos.store(0, std::memory_order_relaxed);
+        totalSamples.store(0, std::memory_order_relaxed);
+        minNanos.store(std::numeric_limits<int64>::max(), std::memory_order_relaxed);
+        for (auto &bucket : buckets) bucket.store(0, std::memory_order_relaxed);
+    }
+};
+
+// Times the `processBlock` calls of one graph node while enabled. Costs one relaxed atomic load per block when disabled.
+struct ProcessorTimer {
+    template<typename Process>
+    void time(int numSamples, Process &&process) {
+        if (!enabled.load(std::memory_order_relaxed)) return process();
+
+        const auto startTicks = ProcessorTimingStats::getTicks();
+        process();
+        stats.record(startTicks, numSamples);
+    }
+
+    // Any thread. Enabling starts over from empty stats.
+    void setEnabled(bool enabled) {
+        if (enabled && !this->enabled.load()) stats.requestReset();
+        this->enabled = enabled;
+    }
+    bool isEnabled() const { return enabled; }
+    const ProcessorTimingStats &getStats() const { return stats; }
+
+private:
+    std::atomic<bool> enabled{false};
+    ProcessorTimingStats stats;
+};
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+#include "ProcessorTimingStats.h"
+#include "AudioThreadChecker.h"
+
+using namespace juce;
+
+/*!
+ *  The graph node around a third-party plugin, so the graph can time its `processBlock` like any internal processor's,
+ *  whether the graph renders it serially or in parallel.
+ *
+ *  Everything else is passed through to the wrapped plugin, which keeps its own parameters, listeners and editor.
+ *  Only the graph sees this node. The rest of the app keeps using the plugin itself (see `getPlugin`).
+ *  The node mirrors the plugin's total channel counts (see `updateLayoutFromPlugin`) and latency,
+ *  following any later changes the plugin reports.
+ */
+class ProfiledPluginInstance : public AudioPluginInstance, private AudioProcessorListener, private AsyncUpdater {
+public:
+    explicit ProfiledPluginInstance(std::unique_ptr<AudioPluginInstance> pluginToWrap)
+            : AudioPluginInstance(BusesProperties().withInput("Input", AudioChannelSet::stereo()).withOutput("Output", AudioChannelSet::stereo())),
+              plugin(std::move(pluginToWrap)) {
+        updateLayoutFromPlugin();
+        plugin->addListener(this);
+    }
+
+    ~ProfiledPluginInstance() override {
+        plugin->removeListener(this);
+    }
+
+    AudioPluginInstance *getPlugin() const { return plugin.get(); }
+    ProcessorTimer &getTimer() { return timer; }
+
+    // Called on the message thread after the node's channel counts changed to follow the plugin's.
+    // Set by the graph, which needs to rebuild its rendering for the new counts.
+    std::function<void()> onLayoutChanged;
+
+    // Call after changing the plugin's buses. Changes the plugin reports itself are followed automatically.
+    void updateLayoutFromPlugin() {
+        const ScopedLock callbackLock(getCallbackLock());
+        setPlayConfigDetails(plugin->getTotalNumInputChannels(), plugin->getTotalNumOutputChannels(), plugin->getSampleRate(), plugin->getBlockSize());
+        setLatencySamples(plugin->getLatencySamples());
+    }
+
+    void prepareToPlay(double sampleRate, int maximumExpectedSamplesPerBlock) override {
+        plugin->setRateAndBufferSizeDetails(sampleRate, maximumExpectedSamplesPerBlock);
+        plugin->prepareToPlay(sampleRate, maximumExpectedSamplesPerBlock);
+        setLatencySamples(plugin->getLatencySamples());
+    }
+
+    void releaseResources() override { plugin->releaseResources(); }
+    void reset() override { plugin->reset(); }
+
+    void processBlock(AudioBuffer<float> &buffer, MidiBuffer &midiMessages) override {
+        const AudioThreadChecker::Scope checkerScope(this);
+        const ScopedLock callbackLock(plugin->getCallbackLock());
+        timer.time(buffer.getNumSamples(), [&] { plugin->processBlock(buffer, midiMessages); });
+    }
+
+    void processBlockBypassed(AudioBuffer<float> &buffer, MidiBuffer &midiMessages) override {
+        const ScopedLock callbackLock(plugin->getCallbackLock());
+        plugin->processBlockBypassed(buffer, midiMessages);
+    }
+
+    void setNonRealtime(bool isNonRealtime) noexcept override {
+        AudioPluginInstance::setNonRealtime(isNonRealtime);
+        plugin->setNonRealtime(isNonRealtime);
+    }
+
+    void setPlayHead(AudioPlayHead *playHead) override {
+        AudioPluginInstance::setPlayHead(playHead);
+        plugin->setPlayHead(playHead);
+    }
+
+    // Any layout, since the node just hands its buffers to the plugin. The plugin's own layout is set on the plugin.
+    bool isBusesLayoutSupported(const BusesLayout &) const override { return true; }
+
+    const String getName() const override { return plugin->getName(); }
+    double getTailLengthSeconds() const override { return plugin->getTailLengthSeconds(); }
+    bool acceptsMidi() const override { return plugin->acceptsMidi(); }
+    bool producesMidi() const override { return plugin->producesMidi(); }
+    bool isMidiEffect() const override { return plugin->isMidiEffect(); }
+
+    // The plugin's editor is opened on the plugin itself.
+    AudioProcessorEditor *createEditor() override { return nullptr; }
+    bool hasEditor() const override { return false; }
+
+    int getNumPrograms() override { return plugin->getNumPrograms(); }
+    int getCurrentProgram() override { return plugin->getCurrentProgram(); }
+    void setCurrentProgram(int index) override { plugin->setCurrentProgram(index); }
+    const String getProgramName(int index) override { return plugin->getProgramName(index); }
+    void changeProgramName(int index, const String &newName) override { plugin->changeProgramName(index, newName); }
+
+    void getStateInformation(MemoryBlock &destData) override { plugin->getStateInformation(destData); }
+    void setStateInformation(const void *data, int sizeInBytes) override { plugin->setStateInformation(data, sizeInBytes); }
+
+    void fillInPluginDescription(PluginDescription &description) const override { plugin->fillInPluginDescription(description); }
+
+private:
+    std::unique_ptr<AudioPluginInstance> plugin;
+    ProcessorTimer timer;
+
+    void audioProcessorParameterChanged(AudioProcessor *, int, float) override {}
+    void audioProcessorChanged(AudioProcessor *, const ChangeDetails &details) override {
+        if (details.latencyChanged) setLatencySamples(plugin->getLatencySamples());
+        // Bus changes are only reported as a general change, possibly from any thread.
+        if (!layoutMatchesPlugin()) triggerAsyncUpdate();
+    }
+
+    void handleAsyncUpdate() override {
+        if (layoutMatchesPlugin()) return;
+
+        updateLayoutFromPlugin();
+        if (onLayoutChanged != nullptr) onLayoutChanged();
+    }
+
+    bool layoutMatchesPlugin() const {
+        return getTotalNumInputChannels() == plugin->getTotalNumInputChannels() && getTotalNumOutputChannels() == plugin->getTotalNumOutputChannels();
+    }
+};
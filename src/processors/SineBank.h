@@ -1,53 +1,33 @@
 #pragma once
 
-#include "audio_sources/ToneSourceWithParameters.h"
 #include "DefaultAudioProcessor.h"
+#include "OscillatorBank.h"
 
+// Sums a bank of sine partials, each with an amplitude and a frequency parameter, into every output channel.
+// The number of partials is fixed per instance, and saved as its processor's internal options (see `getNumPartials`).
 class SineBank : public DefaultAudioProcessor {
 public:
-    explicit SineBank() : DefaultAudioProcessor(getPluginDescription()),
-                          toneSource1("1", defaultStringFromValue, defaultValueFromString, createDefaultGainParameter),
-                          toneSource2("2", defaultStringFromValue, defaultValueFromString, createDefaultGainParameter),
-                          toneSource3("3", defaultStringFromValue, defaultValueFromString, createDefaultGainParameter),
-                          toneSource4("4", defaultStringFromValue, defaultValueFromString, createDefaultGainParameter) {
+    static constexpr int DEFAULT_NUM_PARTIALS = 4, MAX_NUM_PARTIALS = 256;
 
-        addParameter(toneSource1.getAmpParameter());
-        addParameter(toneSource1.getFreqParameter());
-        addParameter(toneSource2.getAmpParameter());
-        addParameter(toneSource2.getFreqParameter());
-        addParameter(toneSource3.getAmpParameter());
-        addParameter(toneSource3.getFreqParameter());
-        addParameter(toneSource4.getAmpParameter());
-        addParameter(toneSource4.getFreqParameter());
-
-        toneSource1.getAmpParameter()->addListener(this);
-        toneSource1.getFreqParameter()->addListener(this);
-        toneSource2.getAmpParameter()->addListener(this);
-        toneSource2.getFreqParameter()->addListener(this);
-        toneSource3.getAmpParameter()->addListener(this);
-        toneSource3.getFreqParameter()->addListener(this);
-        toneSource4.getAmpParameter()->addListener(this);
-        toneSource4.getFreqParameter()->addListener(this);
-
-        mixerAudioSource.addInputSource(toneSource1.get(), false);
-        mixerAudioSource.addInputSource(toneSource2.get(), false);
-        mixerAudioSource.addInputSource(toneSource3.get(), false);
-        mixerAudioSource.addInputSource(toneSource4.get(), false);
+    explicit SineBank(int numPartials = DEFAULT_NUM_PARTIALS)
+            : DefaultAudioProcessor(getPluginDescription(numPartials)), oscillatorBank(numPartials) {
+        // Parameters alternate amplitude and frequency, so each one's partial is its index / 2.
+        for (int partial = 0; partial < numPartials; partial++) {
+            const String idSuffix(partial + 1);
+            addParameter(createDefaultGainParameter("amp_" + idSuffix, "Amp" + idSuffix, -10.0f));
+            addParameter(new AudioParameterFloat("freq_" + idSuffix, "Freq" + idSuffix, NormalisableRange<float>(110.0f, 8000.0f, 0.0f, 0.3f, false), 880.0f, "Hz",
+                                                 AudioProcessorParameter::genericParameter, defaultStringFromValue, defaultValueFromString));
+        }
 
         for (auto *parameter : getParameters()) {
+            parameter->addListener(this);
             parameterChanged(parameter, dynamic_cast<AudioParameterFloat *>(parameter)->range.convertFrom0to1(parameter->getDefaultValue()));
         }
     }
 
     ~SineBank() override {
-        toneSource1.getAmpParameter()->removeListener(this);
-        toneSource1.getFreqParameter()->removeListener(this);
-        toneSource2.getAmpParameter()->removeListener(this);
-        toneSource2.getFreqParameter()->removeListener(this);
-        toneSource3.getAmpParameter()->removeListener(this);
-        toneSource3.getFreqParameter()->removeListener(this);
-        toneSource4.getAmpParameter()->removeListener(this);
-        toneSource4.getFreqParameter()->removeListener(this);
+        for (auto *parameter : getParameters())
+            parameter->removeListener(this);
     }
 
     static String name() { return "Sine Bank"; }
@@ -55,37 +35,37 @@ public:
     static PluginDescription getPluginDescription() {
         return DefaultAudioProcessor::getPluginDescription(name(), true, false);
     }
+    // Creates a Sine Bank with `numPartials` partials.
+    static PluginDescription getPluginDescription(int numPartials) {
+        return DefaultAudioProcessor::getPluginDescription(name() + ":" + String(numPartials), true, false);
+    }
+    // Offered when creating a Sine Bank.
+    static constexpr int PARTIAL_COUNT_CHOICES[]{DEFAULT_NUM_PARTIALS, 16, 64, MAX_NUM_PARTIALS};
+
+    int getNumPartials() const { return oscillatorBank.getNumPartials(); }
+    // Internal options are just the partial count.
+    static int getNumPartials(const String &internalOptions) {
+        return internalOptions.isEmpty() ? DEFAULT_NUM_PARTIALS : jlimit(1, MAX_NUM_PARTIALS, internalOptions.getIntValue());
+    }
 
     void parameterChanged(AudioProcessorParameter *parameter, float newValue) override {
-        if (parameter == toneSource1.getAmpParameter()) {
-            toneSource1.setAmplitude(newValue);
-        } else if (parameter == toneSource1.getFreqParameter()) {
-            toneSource1.setFrequency(newValue);
-        } else if (parameter == toneSource2.getAmpParameter()) {
-            toneSource2.setAmplitude(newValue);
-        } else if (parameter == toneSource2.getFreqParameter()) {
-            toneSource2.setFrequency(newValue);
-        } else if (parameter == toneSource3.getAmpParameter()) {
-            toneSource3.setAmplitude(newValue);
-        } else if (parameter == toneSource3.getFreqParameter()) {
-            toneSource3.setFrequency(newValue);
-        } else if (parameter == toneSource4.getAmpParameter()) {
-            toneSource4.setAmplitude(newValue);
-        } else if (parameter == toneSource4.getFreqParameter()) {
-            toneSource4.setFrequency(newValue);
-        }
+        const int partial = parameter->getParameterIndex() / 2;
+        if (parameter->getParameterIndex() % 2 == 0) oscillatorBank.setAmplitude(partial, Decibels::decibelsToGain(newValue));
+        else oscillatorBank.setFrequency(partial, newValue);
     }
 
-    void processBlock(AudioSampleBuffer &buffer, MidiBuffer &midiMessages) override {
-        const AudioSourceChannelInfo &channelInfo = AudioSourceChannelInfo(buffer);
-        mixerAudioSource.getNextAudioBlock(channelInfo);
+    void prepareToPlay(double sampleRate, int maximumExpectedSamplesPerBlock) override {
+        oscillatorBank.prepare(sampleRate, maximumExpectedSamplesPerBlock);
     }
 
-private:
-    ToneSourceWithParameters toneSource1;
-    ToneSourceWithParameters toneSource2;
-    ToneSourceWithParameters toneSource3;
-    ToneSourceWithParameters toneSource4;
+    void processAudioBlock(AudioSampleBuffer &buffer, MidiBuffer &midiMessages) override {
+        if (buffer.getNumChannels() == 0) return;
 
-    MixerAudioSource mixerAudioSource;
+        oscillatorBank.process(buffer.getWritePointer(0), buffer.getNumSamples());
+        for (int channel = 1; channel < buffer.getNumChannels(); channel++)
+            buffer.copyFrom(channel, 0, buffer, 0, 0, buffer.getNumSamples());
+    }
+
+private:
+    OscillatorBank oscillatorBank;
 };
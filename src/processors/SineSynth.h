@@ -24,7 +24,7 @@ public:
         synth.setCurrentPlaybackSampleRate(newSampleRate);
     }
 
-    void processBlock(AudioBuffer<float> &buffer, MidiBuffer &midiMessages) override {
+    void processAudioBlock(AudioBuffer<float> &buffer, MidiBuffer &midiMessages) override {
         const int numSamples = buffer.getNumSamples();
 
         buffer.clear();
@@ -70,9 +70,13 @@ void StatefulAudioProcessorWrapper::Parameter::setValue(float newValue) {
     if (value != newValue || listenersNeedCalling) {
         value = newValue;
         postUnnormalizedValue(value);
-        setAttachedComponentValues(value);
+        // Changes from anywhere else (e.g. a plugin's own automation on its audio thread) reach the attached components
+        // when the dirty parameters are drained on the message thread.
+        if (MessageManager::getInstance()->isThisTheMessageThread())
+            setAttachedComponentValues(value);
         listenersNeedCalling = false;
-        needsUpdate = true;
+        if (!needsUpdate.exchange(true) && processorWrapper->dirtyParameters != nullptr)
+            processorWrapper->dirtyParameters->push(this);
     }
 }
 
@@ -109,8 +113,22 @@ void StatefulAudioProcessorWrapper::Parameter::setAttachedComponentValues(float
 
 void StatefulAudioProcessorWrapper::Parameter::postUnnormalizedValue(float unnormalizedValue) {
     ScopedValueSetter<bool> svs(ignoreCallbacks, true);
-    if (convertNormalizedToUnnormalized(sourceParameter->getValue()) != unnormalizedValue) {
-        sourceParameter->setValueNotifyingHost(range.convertTo0to1(unnormalizedValue));
+    // Nothing to do if the source parameter already holds the value (e.g. it's where the change came from),
+    // unless a queued value is about to overwrite it. Then, only a different value needs queueing after it.
+    // The first value is always sent, so listeners start out in sync.
+    const bool isPending = numPendingPosts.load(std::memory_order_acquire) > 0;
+    if (!listenersNeedCalling &&
+        (isPending ? postedValue == unnormalizedValue : convertNormalizedToUnnormalized(sourceParameter->getValue()) == unnormalizedValue))
+        return;
+
+    postedValue = unnormalizedValue;
+    const float normalizedValue = range.convertTo0to1(unnormalizedValue);
+    if (auto *parameterChangeQueue = processorWrapper->parameterChangeQueue) {
+        // The audio thread picks the value up at the start of its next block, and notifies the processor then.
+        // The value tree and attached components are updated from the dirty parameters, on the message thread.
+        parameterChangeQueue->post(processorWrapper->audioProcessor, sourceParameter, normalizedValue, &numPendingPosts);
+    } else {
+        sourceParameter->setValueNotifyingHost(normalizedValue);
     }
 }
 
@@ -316,8 +334,9 @@ void StatefulAudioProcessorWrapper::Parameter::parameterControlValueChanged(Para
     setUnnormalizedValue(control->getValue());
 }
 
-StatefulAudioProcessorWrapper::StatefulAudioProcessorWrapper(AudioPluginInstance *audioProcessor, Processor *processor, UndoManager &undoManager) :
-        audioProcessor(audioProcessor), nodeId(processor->getNodeId()) {
+StatefulAudioProcessorWrapper::StatefulAudioProcessorWrapper(AudioPluginInstance *audioProcessor, Processor *processor, UndoManager &undoManager,
+                                                             ParameterChangeQueue *parameterChangeQueue, DirtyParameters *dirtyParameters) :
+        audioProcessor(audioProcessor), parameterChangeQueue(parameterChangeQueue), dirtyParameters(dirtyParameters), nodeId(processor->getNodeId()) {
     audioProcessor->enableAllBuses();
     if (auto *ioProcessor = dynamic_cast<AudioProcessorGraph::AudioGraphIOProcessor *>(audioProcessor)) {
         if (ioProcessor->isInput()) {
@@ -351,6 +370,12 @@ StatefulAudioProcessorWrapper::~StatefulAudioProcessorWrapper() {
     automatableParameters.clear(false);
 }
 
+void StatefulAudioProcessorWrapper::stopListeningToParameters() {
+    // Removing a listener waits for any callback to it in progress, since both hold the parameter's listener lock.
+    for (auto *parameter : parameters)
+        parameter->sourceParameter->removeListener(parameter);
+}
+
 bool StatefulAudioProcessorWrapper::flushParameterValuesToValueTree() {
     ScopedLock lock(valueTreeChanging);
 
@@ -359,6 +384,7 @@ bool StatefulAudioProcessorWrapper::flushParameterValuesToValueTree() {
         bool needsUpdateTestValue = true;
         if (ap->needsUpdate.compare_exchange_strong(needsUpdateTestValue, false)) {
             ap->copyValueToValueTree();
+            ap->setAttachedComponentValues(ap->value);
             anythingUpdated = true;
         }
     }
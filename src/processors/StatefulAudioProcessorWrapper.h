@@ -5,11 +5,16 @@
 
 #include "model/Channel.h"
 #include "model/Processor.h"
+#include "ParameterChangeQueue.h"
+#include "ProcessorTimingStats.h"
+#include "MpscQueue.h"
 #include "view/parameter_control/ParameterControl.h"
 #include "view/parameter_control/level_meter/LevelMeterSource.h"
 #include "view/processor_editor/SwitchParameterComponent.h"
 
 struct StatefulAudioProcessorWrapper {
+    struct DirtyParameters;
+
     struct Parameter
             : public AudioProcessorParameterWithID,
               private ValueTree::Listener,
@@ -74,7 +79,8 @@ struct StatefulAudioProcessorWrapper {
         std::function<float(const String &)> textToValueFunction;
         NormalisableRange<float> range;
 
-        std::atomic<bool> needsUpdate{true};
+        // Set when the value changes, and cleared once it's been copied to the value tree and the attached components.
+        std::atomic<bool> needsUpdate{false};
         ValueTree state;
         UndoManager *undoManager{nullptr};
         StatefulAudioProcessorWrapper *processorWrapper;
@@ -83,6 +89,9 @@ struct StatefulAudioProcessorWrapper {
         bool listenersNeedCalling{true};
         bool ignoreParameterChangedCallbacks = false;
         bool ignoreCallbacks{false};
+        float postedValue{std::numeric_limits<float>::quiet_NaN()};
+        // Posted values the audio thread hasn't applied yet.
+        std::atomic<int> numPendingPosts{0};
         CriticalSection selfCallbackMutex;
 
         OwnedArray<Label> attachedLabels{};
@@ -113,7 +122,10 @@ struct StatefulAudioProcessorWrapper {
         }
     };
 
-    StatefulAudioProcessorWrapper(AudioPluginInstance *audioProcessor, Processor *processor, UndoManager &undoManager);
+    // Parameter changes are posted to the `parameterChangeQueue` if provided, and set directly otherwise.
+    // Changed parameters are pushed to `dirtyParameters` to be copied to their value trees.
+    StatefulAudioProcessorWrapper(AudioPluginInstance *audioProcessor, Processor *processor, UndoManager &undoManager,
+                                  ParameterChangeQueue *parameterChangeQueue = nullptr, DirtyParameters *dirtyParameters = nullptr);
 
     ~StatefulAudioProcessorWrapper();
 
@@ -126,8 +138,14 @@ struct StatefulAudioProcessorWrapper {
     Parameter *getAutomatableParameter(int parameterIndex) { return automatableParameters[parameterIndex]; }
 
     bool flushParameterValuesToValueTree();
+    // Stop following changes made by the processor itself. Once this returns, none of the parameters are queued again.
+    void stopListeningToParameters();
 
     AudioPluginInstance *audioProcessor;
+    ParameterChangeQueue *parameterChangeQueue;
+    DirtyParameters *dirtyParameters;
+    // Times the processor's graph node. Set by the graph.
+    const ProcessorTimer *timer{};
 
 private:
     juce::AudioProcessorGraph::NodeID nodeId;
@@ -137,3 +155,19 @@ private:
 
     CriticalSection valueTreeChanging;
 };
+
+// Parameters whose values changed since they were last copied to their value trees.
+// Pushed to from any thread, and drained on the message thread.
+struct StatefulAudioProcessorWrapper::DirtyParameters {
+    void push(Parameter *parameter) noexcept {
+        if (!queue.push(parameter)) {
+            overflowed = true;
+            numOverflows.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    MpscQueue<Parameter *, 8192> queue;
+    // When a push doesn't fit, the next flush scans every parameter instead.
+    std::atomic<bool> overflowed{false};
+    std::atomic<int64> numOverflows{0};
+};
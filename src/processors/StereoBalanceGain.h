@@ -0,0 +1,85 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+
+using namespace juce;
+
+/*!
+ *  Smoothed stereo balance followed by smoothed gain, shared by the processors that run on every track.
+ *
+ *  Balance is linear with 0dB at center (http://www.kvraudio.com/forum/viewtopic.php?t=148865):
+ *  the left channel gain is `min(1, 1 - balance)` and the right is `min(1, 1 + balance)`.
+ *  While neither value is smoothing, each channel is scaled by a constant. Otherwise, the per-sample channel gains
+ *  are built once per block with vector operations, and applied to both channels in a single pass each.
+ */
+struct StereoBalanceGain {
+    explicit StereoBalanceGain(bool hasGain = true) : hasGain(hasGain) {}
+
+    void prepare(double sampleRate, int maximumBlockSize) {
+        balance.reset(sampleRate, 0.05);
+        gain.reset(sampleRate, 0.05);
+        gains.setSize(NUM_SCRATCH_CHANNELS, jmax(1, maximumBlockSize));
+    }
+
+    void setBalance(float newBalance) { balance.setTargetValue(newBalance); }
+    float getBalance() const { return balance.getTargetValue(); }
+    void setGain(float newGain) { gain.setTargetValue(newGain); }
+
+    void process(AudioSampleBuffer &buffer) {
+        if (buffer.getNumChannels() != 2) {
+            if (hasGain) gain.applyGain(buffer, buffer.getNumSamples());
+            return;
+        }
+
+        const int maxChunkSize = gains.getNumSamples();
+        for (int start = 0; start < buffer.getNumSamples(); start += maxChunkSize)
+            processStereo(buffer.getWritePointer(0, start), buffer.getWritePointer(1, start), jmin(maxChunkSize, buffer.getNumSamples() - start));
+    }
+
+private:
+    enum { LEFT_GAINS, RIGHT_GAINS, GAIN_RAMP, NUM_SCRATCH_CHANNELS };
+
+    bool hasGain;
+    LinearSmoothedValue<float> balance{0.0f};
+    LinearSmoothedValue<float> gain{1.0f};
+    AudioBuffer<float> gains{NUM_SCRATCH_CHANNELS, 1};
+
+    void processStereo(float *left, float *right, int numSamples) {
+        const bool gainIsSmoothing = hasGain && gain.isSmoothing();
+        if (!balance.isSmoothing() && !gainIsSmoothing) {
+            const float balanceValue = balance.getTargetValue(), gainValue = hasGain ? gain.getTargetValue() : 1.0f;
+            const float leftGain = jmin(1.0f, 1.0f - balanceValue) * gainValue, rightGain = jmin(1.0f, 1.0f + balanceValue) * gainValue;
+            if (leftGain != 1.0f) FloatVectorOperations::multiply(left, leftGain, numSamples);
+            if (rightGain != 1.0f) FloatVectorOperations::multiply(right, rightGain, numSamples);
+            return;
+        }
+
+        auto *leftGains = gains.getWritePointer(LEFT_GAINS), *rightGains = gains.getWritePointer(RIGHT_GAINS);
+        if (balance.isSmoothing()) {
+            auto *balanceRamp = gains.getWritePointer(GAIN_RAMP);
+            for (int i = 0; i < numSamples; i++) balanceRamp[i] = balance.getNextValue();
+            FloatVectorOperations::multiply(leftGains, balanceRamp, -1.0f, numSamples);
+            FloatVectorOperations::add(leftGains, 1.0f, numSamples);
+            FloatVectorOperations::min(leftGains, leftGains, 1.0f, numSamples);
+            FloatVectorOperations::add(rightGains, balanceRamp, 1.0f, numSamples);
+            FloatVectorOperations::min(rightGains, rightGains, 1.0f, numSamples);
+        } else {
+            const float balanceValue = balance.getTargetValue();
+            FloatVectorOperations::fill(leftGains, jmin(1.0f, 1.0f - balanceValue), numSamples);
+            FloatVectorOperations::fill(rightGains, jmin(1.0f, 1.0f + balanceValue), numSamples);
+        }
+
+        if (gainIsSmoothing) {
+            auto *gainRamp = gains.getWritePointer(GAIN_RAMP);
+            for (int i = 0; i < numSamples; i++) gainRamp[i] = gain.getNextValue();
+            FloatVectorOperations::multiply(leftGains, gainRamp, numSamples);
+            FloatVectorOperations::multiply(rightGains, gainRamp, numSamples);
+        } else if (hasGain && gain.getTargetValue() != 1.0f) {
+            FloatVectorOperations::multiply(leftGains, gain.getTargetValue(), numSamples);
+            FloatVectorOperations::multiply(rightGains, gain.getTargetValue(), numSamples);
+        }
+
+        FloatVectorOperations::multiply(left, leftGains, numSamples);
+        FloatVectorOperations::multiply(right, rightGains, numSamples);
+    }
+};
@@ -1,50 +1,68 @@
 #pragma once
 
+#include <functional>
+
 #include "Push2Display.h"
+#include "Push2FrameConverter.h"
 #include "Push2UsbCommunicator.h"
+#include "TripleBuffer.h"
 
 /*!
  *  Implements a bridge between juce::Graphics and push2 display format.
+ *
+ *  Frames are painted on the message thread (components can't be painted anywhere else) into one of three images,
+ *  which are triple-buffered to a converter thread. The converter thread converts the latest painted image
+ *  and hands it to the usb communicator, which triple-buffers it again to the usb thread.
+ *  So painting never waits on conversion or usb transfers, and no frame is sent while it's being written.
+ *  Painting is skipped while the last painted frame is still on its way to the display, so frames are painted
+ *  no faster than the display takes them.
  */
-class Push2DisplayBridge {
+class Push2DisplayBridge : private Thread {
 public:
     static const int PUSH_2_VENDOR_ID = 0x2982;
     static const int PUSH_2_PRODUCT_ID = 0x1967;
 
-    Push2DisplayBridge() : image(Image::RGB, Push2Display::WIDTH, Push2Display::HEIGHT, false),
-                           graphics(image), usbCommunicator(PUSH_2_VENDOR_ID, PUSH_2_PRODUCT_ID) {}
+    Push2DisplayBridge() : Thread("Push 2 display"), usbCommunicator(PUSH_2_VENDOR_ID, PUSH_2_PRODUCT_ID),
+                           convertedFrame(size_t(Push2UsbCommunicator::LINE_WIDTH * Push2Display::HEIGHT), true) {
+        // Software images, so their pixels can be read directly (and off the message thread).
+        for (auto &image : images)
+            image = Image(Image::RGB, Push2Display::WIDTH, Push2Display::HEIGHT, false, SoftwareImageType());
+        startThread();
+    }
 
-    juce::Graphics &getGraphics() { return graphics; }
+    ~Push2DisplayBridge() override { stopThread(1000); }
 
-    inline void writeFrameToDisplay() {
-        if (!usbCommunicator.isValid()) return;
+    void usbDevicesChanged() { usbCommunicator.usbDevicesChanged(); }
 
-        static const Push2Display::pixel_t xOrMasks[2] = {0xf3e7, 0xffe7};
-        for (int y = 0; y < Push2Display::HEIGHT; y++) {
-            for (int x = 0; x < Push2Display::WIDTH; x++) {
-                usbCommunicator.setPixelValue(x, y, pixelFromColour(image.getPixelAt(x, y)) ^ xOrMasks[x % 2]);
-            }
-        }
-        usbCommunicator.onFrameFillCompleted();
-    }
+    // Call on the message thread. `paint` must paint the whole display.
+    void renderFrame(const std::function<void(Graphics &)> &paint) {
+        if (!usbCommunicator.isValid() || paintedImages.hasFresh() || usbCommunicator.isFrameQueued()) return;
 
-    /*!
-     * \return pixel_t value in push display format from (r, g, b)
-     * The display uses 16 bit per pixels in a 5:6:5 format
-     *      MSB                           LSB
-     *      b b b b|b g g g|g g g r|r r r r
-     */
-    inline static Push2Display::pixel_t pixelFromColour(juce::Colour &&colour) {
-        auto pixel = static_cast<Push2Display::pixel_t>((colour.getBlue() & 0xF8) >> 3);
-        pixel <<= 6;
-        pixel += (colour.getGreen() & 0xFC) >> 2;
-        pixel <<= 5;
-        pixel += (colour.getRed() & 0xF8) >> 3;
-        return pixel;
+        {
+            Graphics g(images[paintedImages.getWriteIndex()]);
+            paint(g);
+        }
+        paintedImages.publish();
+        notify();
     }
 
 private:
-    juce::Image image;
-    juce::Graphics graphics;
+    Image images[3];
+    TripleBuffer paintedImages;
+    Push2FrameConverter frameConverter;
     Push2UsbCommunicator usbCommunicator;
+    // Converter thread only. Bands that didn't change are only converted once, into this.
+    HeapBlock<Push2Display::pixel_t> convertedFrame;
+
+    void run() override {
+        while (!threadShouldExit()) {
+            wait(100);
+            if (!paintedImages.acquire() || !usbCommunicator.isValid()) continue;
+
+            const bool changed = frameConverter.convert(images[paintedImages.getReadIndex()], convertedFrame, Push2UsbCommunicator::LINE_WIDTH);
+            if (changed)
+                std::copy(convertedFrame.get(), convertedFrame.get() + Push2UsbCommunicator::LINE_WIDTH * Push2Display::HEIGHT, usbCommunicator.getBackFrame());
+            usbCommunicator.onFrameFillCompleted(changed);
+        }
+    }
 };
@@ -0,0 +1,180 @@
+#pragma once
+
+#include <array>
+#include <cstring>
+
+#if defined(__SSSE3__) || defined(__x86_64__) || defined(_M_X64)
+#include <tmmintrin.h>
+#define FLOWGRID_PUSH2_CONVERT_SSSE3 1
+#if !defined(__SSSE3__) && defined(__GNUC__)
+// Default x86 builds don't enable SSSE3, so its path is compiled for SSSE3 on its own, and only taken if the cpu has it.
+#define FLOWGRID_PUSH2_SSSE3_TARGET __attribute__((target("ssse3")))
+#else
+#define FLOWGRID_PUSH2_SSSE3_TARGET
+#endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define FLOWGRID_PUSH2_CONVERT_NEON 1
+#endif
+
+#include <juce_graphics/juce_graphics.h>
+
+#include "Push2Display.h"
+
+using namespace juce;
+
+/*!
+ *  Converts frames rendered into a software `Image::RGB` image into the Push 2 display format,
+ *  reading the image's pixel data directly.
+ *
+ *  The display uses 16 bits per pixel in a 5:6:5 format, XOR-masked with a pattern alternating per pixel:
+ *      MSB                           LSB
+ *      b b b b|b g g g|g g g r|r r r r
+ *
+ *  Lines are converted 16 pixels at a time with SSSE3 (checked at runtime, unless the build targets it) or NEON where available.
+ *  The frame is compared against the previous one in bands of `LINES_PER_BAND` lines (one USB send buffer),
+ *  and only the bands that changed are converted.
+ */
+struct Push2FrameConverter {
+    static constexpr int LINES_PER_BAND = 8;
+
+    Push2FrameConverter() : previousFrame(size_t(LINE_SIZE_BYTES * Push2Display::HEIGHT)) {}
+
+    // Converts the bands of `image` that changed since the last call into `destination`, which has
+    // `destinationLineWidth` pixels per line. Returns `false` if nothing changed.
+    bool convert(const Image &image, Push2Display::pixel_t *destination, int destinationLineWidth) {
+        const Image::BitmapData bitmap(image, Image::BitmapData::readOnly);
+        jassert(bitmap.pixelFormat == Image::RGB && bitmap.pixelStride == 3);
+        jassert(bitmap.width == Push2Display::WIDTH && bitmap.height == Push2Display::HEIGHT);
+
+        bool anyChanged = false;
+        for (int firstLine = 0; firstLine < Push2Display::HEIGHT; firstLine += LINES_PER_BAND) {
+            bool bandChanged = !hasPreviousFrame;
+            for (int line = firstLine; line < firstLine + LINES_PER_BAND && !bandChanged; line++)
+                bandChanged = std::memcmp(bitmap.getLinePointer(line), getPreviousLine(line), size_t(LINE_SIZE_BYTES)) != 0;
+            if (!bandChanged) continue;
+
+            anyChanged = true;
+            for (int line = firstLine; line < firstLine + LINES_PER_BAND; line++) {
+                convertLine(bitmap.getLinePointer(line), destination + line * destinationLineWidth);
+                std::memcpy(getPreviousLine(line), bitmap.getLinePointer(line), size_t(LINE_SIZE_BYTES));
+            }
+        }
+        hasPreviousFrame = true;
+        return anyChanged;
+    }
+
+private:
+    static constexpr int LINE_SIZE_BYTES = Push2Display::WIDTH * 3;
+    // Even pixels first, in the low half of each 32-bit word.
+    static constexpr uint32 XOR_MASKS = 0xffe7f3e7;
+
+    // Byte offsets of the channels in a `PixelRGB`, which differ between platforms.
+    struct ChannelOffsets {
+        int r, g, b;
+    };
+
+    static ChannelOffsets getChannelOffsets() {
+        PixelRGB pixel;
+        pixel.setARGB(0xff, 0, 1, 2);
+        const auto *bytes = reinterpret_cast<const uint8 *>(&pixel);
+        ChannelOffsets offsets{};
+        for (int i = 0; i < 3; i++) {
+            if (bytes[i] == 0) offsets.r = i;
+            else if (bytes[i] == 1) offsets.g = i;
+            else offsets.b = i;
+        }
+        return offsets;
+    }
+
+    HeapBlock<uint8> previousFrame;
+    bool hasPreviousFrame{false};
+
+    uint8 *getPreviousLine(int line) { return previousFrame.get() + line * LINE_SIZE_BYTES; }
+
+    static Push2Display::pixel_t toPixel(uint8 r, uint8 g, uint8 b) {
+        return static_cast<Push2Display::pixel_t>(((b & 0xF8) << 8) | ((g & 0xFC) << 3) | (r >> 3));
+    }
+
+    static void convertLine(const uint8 *source, Push2Display::pixel_t *destination) {
+        static const auto offsets = getChannelOffsets();
+        int x = 0;
+#if FLOWGRID_PUSH2_CONVERT_SSSE3
+#if defined(__SSSE3__)
+        x = convertPixelsSsse3(source, destination, offsets);
+#else
+        static const bool hasSsse3 = SystemStats::hasSSSE3();
+        if (hasSsse3) x = convertPixelsSsse3(source, destination, offsets);
+#endif
+#elif FLOWGRID_PUSH2_CONVERT_NEON
+        x = convertPixelsNeon(source, destination, offsets);
+#endif
+        for (; x < Push2Display::WIDTH; x++) {
+            const auto *pixel = source + x * 3;
+            const auto xorMask = static_cast<Push2Display::pixel_t>(x % 2 == 0 ? XOR_MASKS & 0xffff : XOR_MASKS >> 16);
+            destination[x] = static_cast<Push2Display::pixel_t>(toPixel(pixel[offsets.r], pixel[offsets.g], pixel[offsets.b]) ^ xorMask);
+        }
+    }
+
+    // Each of these converts as many whole groups of 16 pixels as the line has, and returns the number of pixels converted.
+#if FLOWGRID_PUSH2_CONVERT_SSSE3
+    FLOWGRID_PUSH2_SSSE3_TARGET static int convertPixelsSsse3(const uint8 *source, Push2Display::pixel_t *destination, const ChannelOffsets &offsets) {
+        int x = 0;
+        // Gathers each channel of 16 pixels (48 bytes, in three registers) into one register.
+        static const auto shuffles = [&offsets] {
+            std::array<std::array<__m128i, 3>, 3> masks{};
+            const int channelOffsets[3]{offsets.r, offsets.g, offsets.b};
+            for (int channel = 0; channel < 3; channel++) {
+                for (int part = 0; part < 3; part++) {
+                    alignas(16) int8 mask[16];
+                    for (int i = 0; i < 16; i++) {
+                        const int byteIndex = i * 3 + channelOffsets[channel] - part * 16;
+                        mask[i] = byteIndex >= 0 && byteIndex < 16 ? int8(byteIndex) : int8(-128);
+                    }
+                    masks[size_t(channel)][size_t(part)] = _mm_load_si128(reinterpret_cast<const __m128i *>(mask));
+                }
+            }
+            return masks;
+        }();
+
+        const auto zero = _mm_setzero_si128(), xorMasks = _mm_set1_epi32(int(XOR_MASKS));
+        const auto fiveBitMask = _mm_set1_epi16(0xF8), sixBitMask = _mm_set1_epi16(0xFC);
+        for (; x + 16 <= Push2Display::WIDTH; x += 16) {
+            const auto *bytes = reinterpret_cast<const __m128i *>(source + x * 3);
+            const __m128i parts[3]{_mm_loadu_si128(bytes), _mm_loadu_si128(bytes + 1), _mm_loadu_si128(bytes + 2)};
+            __m128i channels[3];
+            for (size_t channel = 0; channel < 3; channel++)
+                channels[channel] = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(parts[0], shuffles[channel][0]), _mm_shuffle_epi8(parts[1], shuffles[channel][1])),
+                                                 _mm_shuffle_epi8(parts[2], shuffles[channel][2]));
+
+            for (int half = 0; half < 2; half++) {
+                const auto r = half == 0 ? _mm_unpacklo_epi8(channels[0], zero) : _mm_unpackhi_epi8(channels[0], zero);
+                const auto g = half == 0 ? _mm_unpacklo_epi8(channels[1], zero) : _mm_unpackhi_epi8(channels[1], zero);
+                const auto b = half == 0 ? _mm_unpacklo_epi8(channels[2], zero) : _mm_unpackhi_epi8(channels[2], zero);
+                const auto pixels = _mm_or_si128(_mm_or_si128(_mm_slli_epi16(_mm_and_si128(b, fiveBitMask), 8), _mm_slli_epi16(_mm_and_si128(g, sixBitMask), 3)),
+                                                 _mm_srli_epi16(r, 3));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(destination + x + half * 8), _mm_xor_si128(pixels, xorMasks));
+            }
+        }
+        return x;
+    }
+#elif FLOWGRID_PUSH2_CONVERT_NEON
+    static int convertPixelsNeon(const uint8 *source, Push2Display::pixel_t *destination, const ChannelOffsets &offsets) {
+        int x = 0;
+        const auto xorMasks = vreinterpretq_u16_u32(vdupq_n_u32(XOR_MASKS));
+        const auto fiveBitMask = vdupq_n_u16(0xF8), sixBitMask = vdupq_n_u16(0xFC);
+        for (; x + 16 <= Push2Display::WIDTH; x += 16) {
+            const auto channels = vld3q_u8(source + x * 3);
+            const auto r8 = channels.val[offsets.r], g8 = channels.val[offsets.g], b8 = channels.val[offsets.b];
+            for (int half = 0; half < 2; half++) {
+                const auto r = vmovl_u8(half == 0 ? vget_low_u8(r8) : vget_high_u8(r8));
+                const auto g = vmovl_u8(half == 0 ? vget_low_u8(g8) : vget_high_u8(g8));
+                const auto b = vmovl_u8(half == 0 ? vget_low_u8(b8) : vget_high_u8(b8));
+                const auto pixels = vorrq_u16(vorrq_u16(vshlq_n_u16(vandq_u16(b, fiveBitMask), 8), vshlq_n_u16(vandq_u16(g, sixBitMask), 3)), vshrq_n_u16(r, 3));
+                vst1q_u16(destination + x + half * 8, veorq_u16(pixels, xorMasks));
+            }
+        }
+        return x;
+    }
+#endif
+};
@@ -74,6 +74,7 @@ void Push2MidiCommunicator::initialize() {
 }
 
 Push2MidiCommunicator::~Push2MidiCommunicator() {
+    cancelPendingUpdate();
     push2Colours.removeListener(this);
 }
 
@@ -84,39 +85,67 @@ void Push2MidiCommunicator::handleIncomingMidiMessage(MidiInput *source, const M
         MidiCommunicator::handleIncomingMidiMessage(source, message);
     }
 
-    MessageManager::callAsync([this, source, message]() {
-        if (push2Listener == nullptr) return;
-
-        if (message.isController()) {
-            const auto ccNumber = message.getControllerNumber();
-            if (isEncoderCcNumber(ccNumber)) {
-                float changeAmount = encoderCcMessageToRotationChange(message);
-                if (ccNumber == masterKnob) {
-                    return push2Listener->masterEncoderRotated(changeAmount / 2.0f);
-                }
-                if (isAboveScreenEncoderCcNumber(ccNumber)) {
-                    return push2Listener->encoderRotated(ccNumber - topKnob3, changeAmount / 2.0f);
-                }
-                return;
-            }
+    // Nothing on the message thread handles anything else (like the high-rate polyphonic aftertouch).
+    if (!message.isController() && !message.isNoteOnOrOff()) return;
 
-            if (isButtonPressControlMessage(message)) {
-                static const Array<int> repeatableButtonCcNumbers{undo, up, down, left, right};
-                if (repeatableButtonCcNumbers.contains(ccNumber)) {
-                    buttonHoldStopped();
-                    currentlyHeldRepeatableButtonCcNumber = ccNumber;
-                    startTimer(BUTTON_HOLD_WAIT_FOR_REPEAT_MS);
-                }
-                return handleButtonPressMidiCcNumber(ccNumber);
-            }
-            if (isButtonReleaseControlMessage(message)) {
+    IncomingMessage incoming{source, {}, jmin(3, message.getRawDataSize())};
+    std::copy(message.getRawData(), message.getRawData() + incoming.size, incoming.data);
+    // If the message thread is this far behind, dropping messages is the least of our problems.
+    if (incomingMessages.push(incoming)) triggerAsyncUpdate();
+}
+
+void Push2MidiCommunicator::handleAsyncUpdate() {
+    IncomingMessage incoming{};
+    while (incomingMessages.pop(incoming)) {
+        const MidiMessage message(incoming.data, incoming.size);
+        if (message.isController() && isEncoderCcNumber(message.getControllerNumber())) {
+            pendingEncoderRotations[size_t(message.getControllerNumber())] += encoderCcMessageToRotationChange(message);
+            anyEncoderRotationPending = true;
+            continue;
+        }
+        // Keep rotations in order with everything else.
+        flushPendingEncoderRotations();
+        handleMessage(incoming.source, message);
+    }
+    flushPendingEncoderRotations();
+}
+
+void Push2MidiCommunicator::flushPendingEncoderRotations() {
+    if (!anyEncoderRotationPending) return;
+
+    anyEncoderRotationPending = false;
+    for (int ccNumber = 0; ccNumber < int(pendingEncoderRotations.size()); ccNumber++) {
+        const float changeAmount = std::exchange(pendingEncoderRotations[size_t(ccNumber)], 0.0f);
+        if (changeAmount == 0.0f || push2Listener == nullptr) continue;
+
+        if (ccNumber == masterKnob)
+            push2Listener->masterEncoderRotated(changeAmount / 2.0f);
+        else if (isAboveScreenEncoderCcNumber(ccNumber))
+            push2Listener->encoderRotated(ccNumber - topKnob3, changeAmount / 2.0f);
+    }
+}
+
+void Push2MidiCommunicator::handleMessage(MidiInput *source, const MidiMessage &message) {
+    if (push2Listener == nullptr) return;
+
+    if (message.isController()) {
+        const auto ccNumber = message.getControllerNumber();
+        if (isButtonPressControlMessage(message)) {
+            static const Array<int> repeatableButtonCcNumbers{undo, up, down, left, right};
+            if (repeatableButtonCcNumbers.contains(ccNumber)) {
                 buttonHoldStopped();
-                return handleButtonReleaseMidiCcNumber(ccNumber);
+                currentlyHeldRepeatableButtonCcNumber = ccNumber;
+                startTimer(BUTTON_HOLD_WAIT_FOR_REPEAT_MS);
             }
-        } else {
-            push2Listener->handleIncomingMidiMessage(source, message);
+            return handleButtonPressMidiCcNumber(ccNumber);
+        }
+        if (isButtonReleaseControlMessage(message)) {
+            buttonHoldStopped();
+            return handleButtonReleaseMidiCcNumber(ccNumber);
         }
-    });
+    } else {
+        push2Listener->handleIncomingMidiMessage(source, message);
+    }
 }
 
 static int directionForArrowButtonCcNumber(int ccNumber) {
@@ -3,8 +3,15 @@
 #include "midi/MidiCommunicator.h"
 #include "view/push2/Push2Listener.h"
 #include "view/push2/Push2Colours.h"
-
-class Push2MidiCommunicator : public MidiCommunicator, private Push2Colours::Listener, private Timer {
+#include "MpscQueue.h"
+
+/*!
+ *  Incoming controller and note messages are queued on the midi thread, without locking or allocating,
+ *  and handled on the message thread in one batch per message-thread callback.
+ *  Rotations of each encoder within a batch are merged into one, so fast encoder sweeps can't flood the message thread.
+ *  (Pad notes are also passed on to the midi input callbacks directly, on the midi thread.)
+ */
+class Push2MidiCommunicator : public MidiCommunicator, private Push2Colours::Listener, private Timer, private AsyncUpdater {
 public:
     static const uint8
             topKnob1 = 14, topKnob2 = 15, topKnob3 = 71, topKnob4 = 72, topKnob5 = 73, topKnob6 = 74, topKnob7 = 75,
@@ -61,6 +68,18 @@ private:
     Push2Colours &push2Colours;
     Push2Listener *push2Listener{};
 
+    // A short (at most three-byte) midi message.
+    struct IncomingMessage {
+        MidiInput *source;
+        uint8 data[3];
+        int size;
+    };
+
+    MpscQueue<IncomingMessage, 512> incomingMessages;
+    // Message thread only. Accumulated rotation of each encoder (by cc number) not yet passed on to the listener.
+    std::array<float, 128> pendingEncoderRotations{};
+    bool anyEncoderRotationPending{false};
+
     int currentlyHeldRepeatableButtonCcNumber{0};
     bool holdRepeatIsHappeningNow{false};
 
@@ -71,4 +90,8 @@ private:
     void trackColourChanged(const String &trackUuid, const Colour &colour) override {}
     void buttonHoldStopped();
     void timerCallback() override;
+
+    void handleAsyncUpdate() override;
+    void handleMessage(MidiInput *source, const MidiMessage &message);
+    void flushPendingEncoderRotations();
 };
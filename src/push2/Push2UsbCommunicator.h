@@ -1,26 +1,61 @@
 #pragma once
 
+#include <algorithm>
+#include <mutex>
 #include <thread>
 #include "usb/UsbCommunicator.h"
 #include "Push2Display.h"
+#include "TripleBuffer.h"
 
 /*!
  *  This class manages the communication with the Push 2 display over usb.
  *
+ *  Frames are filled in on one thread and triple-buffered to the libusb event thread, which only picks up the latest
+ *  completed frame at the start of each frame it sends, so a frame is never sent while it's being filled in.
+ *
+ *  Frames are streamed without copying: a fixed pool of `SEND_BUFFER_COUNT` transfers (allocated once and reused
+ *  across reconnects) point straight into slices of the frame being sent.
+ *  Sending is paced by transfer completion. Each completed transfer is resubmitted with the next slice,
+ *  and the next frame starts once every slice of the previous one has been sent, releasing its frame.
+ *
+ *  Frames are streamed continuously while they change. Once a frame has been sent and no new one has changed,
+ *  the transfers stay idle until a changed frame is filled in, or `KEEP_ALIVE_MILLIS` pass
+ *  (the display blanks itself after two seconds without a frame).
  */
 class Push2UsbCommunicator : public UsbCommunicator {
 public:
+    // Pixels per line of `getBackFrame`, including filler pixels past the display width.
+    static const int LINE_WIDTH = 1024;
+
     Push2UsbCommunicator(const uint16_t vendorId, const uint16_t productId) :
             UsbCommunicator(vendorId, productId), currentLine(0) {}
 
-    inline void setPixelValue(int x, int y, Push2Display::pixel_t value) {
-        pixels[y * LINE_WIDTH + x] = value;
+    ~Push2UsbCommunicator() override {
+        // Cancels any pending transfers and waits for them to return.
+        stopPolling();
+        libusb_free_transfer(frameHeaderTransfer);
+        for (auto *transfer : transfers) libusb_free_transfer(transfer);
     }
 
-    inline void onFrameFillCompleted() {
+    // The frame to fill in, holding an older frame, so it needs to be filled in completely.
+    // Only call from the thread calling `onFrameFillCompleted`.
+    Push2Display::pixel_t *getBackFrame() { return frames[frameBuffers.getWriteIndex()]; }
+
+    // Whether the last changed frame is still waiting to be sent. Frames filled in meanwhile would replace it unseen.
+    bool isFrameQueued() const { return frameBuffers.hasFresh(); }
+
+    // Sends the back frame if `frameChanged`. Otherwise, only the last changed frame is kept alive.
+    inline void onFrameFillCompleted(bool frameChanged) {
+        if (frameChanged) frameBuffers.publish();
+
         if (frameHeaderTransfer == nullptr || headerNeedsSending.load()) {
             startSending();
+            return;
         }
+
+        // Published before locking, so idle transfers either get the new frame here, or on the next completion.
+        const std::lock_guard<std::mutex> lock(sendMutex);
+        submitIdleTransfers();
     }
 
 protected:
@@ -28,7 +63,12 @@ protected:
      *  Initiate the send process
      */
     void startSending() override {
-        currentLine = 0;
+        const std::lock_guard<std::mutex> lock(sendMutex);
+        // Pending transfers are cancelled and returned by the event thread before the device is reopened.
+        // Until then, they can't be reset. The event thread only closes the device after cancelling under this lock,
+        // so a handle read here stays open until this returns.
+        auto *deviceHandle = handle.load();
+        if (deviceHandle == nullptr || isStopping() || headerInFlight || numTransfersInFlight > 0) return;
 
         // transfer struct for the frame header
         static unsigned char frameHeader[16] = {
@@ -39,67 +79,68 @@ protected:
         };
 
         static const unsigned char push2BulkEPOut = 0x01;
-        frameHeaderTransfer = allocateAndPrepareTransferChunk(handle, this, frameHeader, sizeof(frameHeader), push2BulkEPOut);
-
-        for (int i = 0; i < SEND_BUFFER_COUNT; i++) {
-            unsigned char *buffer = (sendBuffers + i * SEND_BUFFER_SIZE);
-
-            // Allocates a transfer struct for the send buffers
-            auto *transfer = allocateAndPrepareTransferChunk(handle, this, buffer, SEND_BUFFER_SIZE, push2BulkEPOut);
-
-            // Start a request for this buffer
-            sendNextSlice(transfer);
+        if (frameHeaderTransfer == nullptr) {
+            frameHeaderTransfer = allocateAndPrepareTransferChunk(deviceHandle, this, frameHeader, sizeof(frameHeader), push2BulkEPOut);
+            // Transfer structs for the frame slices. Their buffers are set to the slice they send on each submission.
+            for (auto *&transfer : transfers)
+                transfer = allocateAndPrepareTransferChunk(deviceHandle, this, reinterpret_cast<unsigned char *>(frames[0]), SEND_BUFFER_SIZE, push2BulkEPOut);
         }
+        // After a reconnect, the same (all idle) transfers are pointed at the new device.
+        frameHeaderTransfer->dev_handle = deviceHandle;
+        numIdleTransfers = 0;
+        for (auto *transfer : transfers) {
+            transfer->dev_handle = deviceHandle;
+            idleTransfers[numIdleTransfers++] = transfer;
+        }
+        numTransfersInFlight = 0;
+        currentLine = 0;
+        // Always send the first frame.
+        lastFrameStartMillis = juce::Time::getMillisecondCounter() - KEEP_ALIVE_MILLIS;
+
+        submitIdleTransfers();
     }
 
     /*!
-     *  Send the next slice of data using the provided transfer struct
+     *  Send the next slice of data using the provided (completed) transfer struct
      */
     void sendNextSlice(libusb_transfer *transfer) override {
-        // Start of a new frame, so send header first
-        if (currentLine == 0) {
-            if (libusb_submit_transfer(frameHeaderTransfer) < 0) {
-                std::cerr << "could not submit frame header transfer" << '\n';
-                headerNeedsSending.store(true);
-                return;
-            }
-            headerNeedsSending.store(false);
-        }
-
-        // Copy the next slice of the source data (represented by currentLine)
-        // to the transfer buffer
-        unsigned char *dst = transfer->buffer;
-
-        const unsigned char *src = (const unsigned char *) pixels + LINE_SIZE_BYTES * currentLine;
-        unsigned char *end = dst + SEND_BUFFER_SIZE;
-
-        while (dst < end) {
-            *dst++ = *src++;
-        }
+        const std::lock_guard<std::mutex> lock(sendMutex);
+        releaseTransfer(transfer);
+        submitIdleTransfers();
+    }
 
-        if (libusb_submit_transfer(transfer) < 0) {
-            std::cerr << "could not submit display data transfer" << '\n';
-            return;
-        }
+    void onTransferReturned(libusb_transfer *transfer) override {
+        const std::lock_guard<std::mutex> lock(sendMutex);
+        releaseTransfer(transfer);
+    }
 
-        // Update slice position
-        currentLine += LINE_COUNT_PER_SEND_BUFFER;
+    void cancelTransfers() override {
+        const std::lock_guard<std::mutex> lock(sendMutex);
+        if (numTransfersInFlight == 0 && !headerInFlight) return;
 
-        if (currentLine >= NUM_LINES) {
-            currentLine = 0;
-        }
+        // Only the pending ones, since idle transfers may still point at a closed device.
+        if (headerInFlight) libusb_cancel_transfer(frameHeaderTransfer);
+        for (auto *transfer : transfers)
+            if (std::find(idleTransfers, idleTransfers + numIdleTransfers, transfer) == idleTransfers + numIdleTransfers)
+                libusb_cancel_transfer(transfer);
     }
 
+    bool hasTransfersInFlight() override {
+        const std::lock_guard<std::mutex> lock(sendMutex);
+        return headerInFlight || numTransfersInFlight > 0;
+    }
 
     /*!
-     *  Callback for when a full frame has been sent
+     *  Callback for when the frame header has been sent
      *  Note that there's no real need of doing double buffering since the
      *  display deals nicely with it already
      */
-    void onFrameSendCompleted() override {}
+    void onFrameSendCompleted() override {
+        const std::lock_guard<std::mutex> lock(sendMutex);
+        releaseTransfer(frameHeaderTransfer);
+    }
 
 private:
-    static const int LINE_WIDTH = 1024;
     static const int NUM_LINES = Push2Display::HEIGHT;
 
     // The display frame size is 960*160*2=300k, but we use 64 extra filler
@@ -112,15 +153,81 @@ private:
     static const int LINE_COUNT_PER_SEND_BUFFER = 8;
 
     // The data sent to the display is sliced into chunks of LINE_COUNT_PER_SEND_BUFFER
-    // and we use SEND_BUFFER_COUNT buffers to communicate so we can prepare the next
+    // and we use SEND_BUFFER_COUNT transfers to communicate so we can prepare the next
     // request without having to wait for the current one to be finished
     // The sent buffer size (SEND_BUFFER_SIZE) must a multiple of these 2k per line,
     // and is selected for optimal performance.
     static const int SEND_BUFFER_COUNT = 3;
     static const int SEND_BUFFER_SIZE = LINE_COUNT_PER_SEND_BUFFER * LINE_SIZE_BYTES; // buffer length in bytes
 
-    Push2Display::pixel_t pixels[Push2UsbCommunicator::LINE_WIDTH * Push2UsbCommunicator::NUM_LINES]{};
-    unsigned char sendBuffers[SEND_BUFFER_COUNT * SEND_BUFFER_SIZE]{};
+    // Filled in by the producer at `frameBuffers.getWriteIndex()`, and sent from `frameBuffers.getReadIndex()`.
+    // Frames stay at fixed addresses, since transfers send straight from them.
+    Push2Display::pixel_t frames[3][Push2UsbCommunicator::LINE_WIDTH * Push2UsbCommunicator::NUM_LINES]{};
+    // Acquired under `sendMutex`, so only one thread at a time consumes it.
+    TripleBuffer frameBuffers;
+    libusb_transfer *transfers[SEND_BUFFER_COUNT]{};
     uint8_t currentLine;
-};
 
+    static const uint32_t KEEP_ALIVE_MILLIS = 1000;
+
+    // Guards the send position and the transfer pool, shared by the frame producer and the libusb event thread.
+    std::mutex sendMutex;
+    libusb_transfer *idleTransfers[SEND_BUFFER_COUNT]{};
+    int numIdleTransfers{0}, numTransfersInFlight{0};
+    bool headerInFlight{false};
+    uint32_t lastFrameStartMillis{0};
+
+    bool isKeepAliveDue() const { return juce::Time::getMillisecondCounter() - lastFrameStartMillis >= KEEP_ALIVE_MILLIS; }
+
+    // Under `sendMutex`.
+    void releaseTransfer(libusb_transfer *transfer) {
+        if (transfer == frameHeaderTransfer) {
+            headerInFlight = false;
+            return;
+        }
+
+        numTransfersInFlight--;
+        idleTransfers[numIdleTransfers++] = transfer;
+    }
+
+    // Under `sendMutex`. Submits idle transfers with the next slices, for as long as there's something to send.
+    void submitIdleTransfers() {
+        // Checked under `sendMutex`, which `cancelTransfers` also holds, so nothing is submitted after it's run.
+        if (isStopping()) return;
+
+        while (numIdleTransfers > 0) {
+            // Start of a new frame, so send header first
+            if (currentLine == 0) {
+                // The previous frame is still being read from, or there's nothing new to send.
+                // The last completing transfer of the previous frame or the next changed frame picks it up from here.
+                if (numTransfersInFlight > 0 || (!frameBuffers.acquire() && !isKeepAliveDue())) return;
+
+                lastFrameStartMillis = juce::Time::getMillisecondCounter();
+                if (libusb_submit_transfer(frameHeaderTransfer) < 0) {
+                    std::cerr << "could not submit frame header transfer" << '\n';
+                    headerNeedsSending.store(true);
+                    return;
+                }
+                headerInFlight = true;
+                headerNeedsSending.store(false);
+            }
+
+            // Point the transfer at the next slice of the frame (represented by currentLine)
+            auto *transfer = idleTransfers[numIdleTransfers - 1];
+            transfer->buffer = reinterpret_cast<unsigned char *>(frames[frameBuffers.getReadIndex()]) + LINE_SIZE_BYTES * currentLine;
+            if (libusb_submit_transfer(transfer) < 0) {
+                std::cerr << "could not submit display data transfer" << '\n';
+                return;
+            }
+            numIdleTransfers--;
+            numTransfersInFlight++;
+
+            // Update slice position
+            currentLine += LINE_COUNT_PER_SEND_BUFFER;
+
+            if (currentLine >= NUM_LINES) {
+                currentLine = 0;
+            }
+        }
+    }
+};
@@ -4,11 +4,13 @@ UsbCommunicator::UsbCommunicator(const uint16_t vendorId, const uint16_t product
         vendorId(vendorId), productId(productId), frameHeaderTransfer(nullptr), terminate(false) {
     auto errorCode = libusb_init(nullptr);
     if (errorCode < 0) throw std::runtime_error("Failed to initialize libusb");
-
-    startTimer(1000); // check back every second
 }
 
 UsbCommunicator::~UsbCommunicator() {
+    stopPolling();
+}
+
+void UsbCommunicator::stopPolling() {
     terminate = true;
     if (pollThread.joinable()) {
         pollThread.join();
@@ -25,7 +27,8 @@ void UsbCommunicator::onTransferFinished(libusb_transfer *transfer) {
                 printf("transfer timed out\n");
                 break;
             case LIBUSB_TRANSFER_CANCELLED:
-                printf("transfer was cancelled\n");
+                // Cancelled while stopping is expected, and not worth reporting.
+                if (!terminate.load()) printf("transfer was cancelled\n");
                 break;
             case LIBUSB_TRANSFER_STALL:
                 printf("endpoint stalled/control request not supported\n");
@@ -43,21 +46,20 @@ void UsbCommunicator::onTransferFinished(libusb_transfer *transfer) {
                 printf("snd transfer failed with status: %d\n", transfer->status);
                 break;
         }
+        onTransferReturned(transfer);
+        // The event thread cancels the rest, and closes the device once they've returned.
         terminate.store(true);
-        libusb_close(handle);
-        handle = nullptr;
     } else if (transfer->length != transfer->actual_length) {
-        char errorMsg[256];
-        sprintf(errorMsg, "only transferred %d of %d bytes\n", transfer->actual_length, transfer->length);
-        throw std::runtime_error(errorMsg);
+        // Handled like a failure, since the transfer still has to be returned before stopping.
+        printf("only transferred %d of %d bytes\n", transfer->actual_length, transfer->length);
+        onTransferReturned(transfer);
+        terminate.store(true);
+    } else if (terminate.load()) {
+        onTransferReturned(transfer);
     } else if (transfer == frameHeaderTransfer) {
-        if (!terminate.load()) {
-            onFrameSendCompleted();
-        }
+        onFrameSendCompleted();
     } else {
-        if (!terminate.load()) {
-            sendNextSlice(transfer);
-        }
+        sendNextSlice(transfer);
     }
 }
 
@@ -69,6 +71,16 @@ void UsbCommunicator::pollUsbForEvents() {
             assert(false);
         }
     }
+
+    // Transfers still pending can't be freed or resubmitted, nor can their device be closed, until their callbacks have run.
+    cancelTransfers();
+    while (hasTransfersInFlight()) {
+        if (libusb_handle_events_timeout_completed(nullptr, &timeout_500ms, nullptr) < 0) {
+            assert(false);
+        }
+    }
+    if (auto *deviceHandle = handle.exchange(nullptr))
+        libusb_close(deviceHandle);
 }
 
 libusb_transfer *UsbCommunicator::allocateAndPrepareTransferChunk(libusb_device_handle *handle, UsbCommunicator *instance, unsigned char *buffer, int bufferSize, const unsigned char endpoint) {
@@ -86,7 +98,9 @@ bool UsbCommunicator::findDeviceHandleAndStartPolling() {
     auto count = libusb_get_device_list(nullptr, &devices);
     if (count < 0) throw std::runtime_error("could not get usb device list");
 
-    // Look for the one matching Push 2's descriptors
+    // Look for the one matching Push 2's descriptors.
+    // Opened into a local, so the handle is only published once its interface is claimed.
+    libusb_device_handle *deviceHandle = nullptr;
     libusb_device *device;
     int errorCode;
     for (int i = 0; (device = devices[i]) != nullptr; i++) {
@@ -99,12 +113,13 @@ bool UsbCommunicator::findDeviceHandleAndStartPolling() {
         if (descriptor.bDeviceClass == LIBUSB_CLASS_PER_INTERFACE
             && descriptor.idVendor == vendorId
             && descriptor.idProduct == productId) {
-            if ((errorCode = libusb_open(device, &handle)) < 0) {
+            if ((errorCode = libusb_open(device, &deviceHandle)) < 0) {
                 std::cerr << "could not open device, error: " << errorCode << '\n';
-            } else if ((errorCode = libusb_claim_interface(handle, 0)) < 0) {
+                deviceHandle = nullptr;
+            } else if ((errorCode = libusb_claim_interface(deviceHandle, 0)) < 0) {
                 std::cerr << "could not claim device with interface 0, error: " << errorCode << '\n';
-                libusb_close(handle);
-                handle = nullptr;
+                libusb_close(deviceHandle);
+                deviceHandle = nullptr;
             } else {
                 break; // successfully opened
             }
@@ -113,19 +128,16 @@ bool UsbCommunicator::findDeviceHandleAndStartPolling() {
 
     libusb_free_device_list(devices, 1);
 
-    if (handle != nullptr) {
+    if (deviceHandle != nullptr) {
         if (pollThread.joinable()) {
             pollThread.join();
             headerNeedsSending.store(true);
             terminate.store(false);
         }
+        handle.store(deviceHandle);
         pollThread = std::thread(&UsbCommunicator::pollUsbForEvents, this);
         return true;
     }
 
     return false;
 }
-
-void UsbCommunicator::timerCallback() {
-    if (handle == nullptr) findDeviceHandleAndStartPolling();
-}
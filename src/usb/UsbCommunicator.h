@@ -7,13 +7,21 @@
 
 #include "libusb.h"
 
-class UsbCommunicator : private juce::Timer {
+class UsbCommunicator {
 public:
     UsbCommunicator(uint16_t vendorId, uint16_t productId);
 
-    ~UsbCommunicator() override;
+    virtual ~UsbCommunicator();
 
-    bool isValid() { return handle != nullptr; }
+    bool isValid() { return handle.load() != nullptr; }
+
+    /*!
+     *  Look for the device if it isn't open yet.
+     *  Call on the message thread whenever usb devices may have changed (see `DeviceChangeMonitor`)
+     */
+    void usbDevicesChanged() {
+        if (handle.load() == nullptr) findDeviceHandleAndStartPolling();
+    }
 
     /*!
      *  Callback for when a transfer is finished and the next one needs to be
@@ -22,7 +30,9 @@ public:
     void LIBUSB_CALL onTransferFinished(libusb_transfer *transfer);
 
     /*!
-     *  Continuously poll events from libusb, possibly treating any error reported
+     *  Continuously poll events from libusb, possibly treating any error reported.
+     *  Once stopping, pending transfers are cancelled and events handled until they've all returned,
+     *  and only then is the device closed.
      */
     void pollUsbForEvents();
 
@@ -32,8 +42,19 @@ protected:
     static libusb_transfer *allocateAndPrepareTransferChunk(libusb_device_handle *handle, UsbCommunicator *instance,
                                                             unsigned char *buffer, int bufferSize, unsigned char endpoint);
 
+    // Stop the event thread once every pending transfer has returned, so no more transfer callbacks are made.
+    // Subclasses owning transfers call this before freeing them.
+    void stopPolling();
+    // Set after a transfer fails or `stopPolling` is called, until the device is reopened. Submit no transfers meanwhile.
+    bool isStopping() const { return terminate.load(); }
+
     virtual void startSending() = 0;
     virtual void sendNextSlice(libusb_transfer *transfer) = 0;
+    // Called for a transfer that won't be resubmitted, since it failed or polling is stopping.
+    virtual void onTransferReturned(libusb_transfer *) {}
+    // Called on the event thread once stopping. Cancel every pending transfer, each of which is then returned.
+    virtual void cancelTransfers() {}
+    virtual bool hasTransfersInFlight() { return false; }
 
     /*!
      *  Note that there's no real need of doing double buffering since the
@@ -44,12 +65,12 @@ protected:
     uint16_t vendorId;
     uint16_t productId;
     libusb_transfer *frameHeaderTransfer;
-    libusb_device_handle *handle{};
+    // Published once the device's interface is claimed, and cleared by the event thread before closing it.
+    // Read from any thread, so re-check it where it's used.
+    std::atomic<libusb_device_handle *> handle{};
     std::atomic<bool> headerNeedsSending{true};
 
 private:
-    void timerCallback() override;
-
     bool findDeviceHandleAndStartPolling();
 
     // Callback received whenever a transfer has been completed.
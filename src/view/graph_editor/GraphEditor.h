@@ -6,17 +6,27 @@
 #include "view/SelectionEditor.h"
 #include "TooltipBar.h"
 
-class GraphEditor : public Component {
+class GraphEditor : public Component, private ChangeListener {
 public:
     GraphEditor(View &view, Tracks &tracks, Connections &connections, Input &input, Output &output, ProcessorGraph &processorGraph, Project &project, PluginManager &pluginManager)
-            : graphEditorPanel(view, tracks, connections, input, output, processorGraph, project, pluginManager),
-              selectionEditor(project, view, tracks, processorGraph.getProcessorWrappers()) {
+            : project(project),
+              graphEditorPanel(view, tracks, connections, input, output, processorGraph, project, pluginManager),
+              selectionEditor(project, view, tracks, processorGraph.getProcessorWrappers()),
+              loadProgressBar(project.getLoadProgress()) {
         addAndMakeVisible(graphEditorPanel);
         addAndMakeVisible(selectionEditor);
+        loadProgressBar.setTextToDisplay(TRANS("Loading tracks"));
+        addChildComponent(loadProgressBar);
+        project.addChangeListener(this);
+    }
+
+    ~GraphEditor() override {
+        project.removeChangeListener(this);
     }
 
     void resized() override {
         auto r = getLocalBounds();
+        loadProgressBar.setBounds(r.withSizeKeepingCentre(jmin(300, r.getWidth()), 24).withY(r.getY() + 8));
         graphEditorPanel.setBounds(r.removeFromLeft(int(r.getWidth() * 0.6f)));
         selectionEditor.setBounds(r);
     }
@@ -26,6 +36,14 @@ public:
     }
 
 private:
+    Project &project;
     GraphEditorPanel graphEditorPanel;
     SelectionEditor selectionEditor;
+    // Shown on top of the graph while a project is streaming in.
+    ProgressBar loadProgressBar;
+
+    void changeListenerCallback(ChangeBroadcaster *source) override {
+        loadProgressBar.setVisible(project.isLoading());
+        if (loadProgressBar.isVisible()) loadProgressBar.toFront(false);
+    }
 };
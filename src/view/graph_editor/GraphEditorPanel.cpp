@@ -23,9 +23,11 @@ GraphEditorPanel::GraphEditorPanel(View &view, Tracks &tracks, Connections &conn
     unfocusOverlay.setFill(findColour(CustomColourIds::unfocusedOverlayColourId));
     addChildComponent(unfocusOverlay);
     addMouseListener(this, true);
+    startTimerHz(4);
 }
 
 GraphEditorPanel::~GraphEditorPanel() {
+    stopTimer();
     removeMouseListener(this);
     stopDragging();
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "view/PluginWindow.h"
+#include "BatchedUpdates.h"
 #include "view/graph_editor/processor/LabelGraphEditorProcessor.h"
 #include "ProcessorGraph.h"
 #include "GraphEditorChannel.h"
@@ -11,7 +12,7 @@
 
 class GraphEditorPanel
         : public Component, public ConnectorDragListener, public GraphEditorProcessorContainer,
-          private ValueTree::Listener, StatefulList<Track>::Listener, StatefulList<Processor>::Listener {
+          private ValueTree::Listener, StatefulList<Track>::Listener, StatefulList<Processor>::Listener, private Timer {
 public:
     GraphEditorPanel(View &view, Tracks &tracks, Connections &connections, Input &input, Output &output, ProcessorGraph &processorGraph, Project &project, PluginManager &pluginManager);
 
@@ -54,9 +55,17 @@ private:
     AudioProcessorGraph::Connection initialDraggingConnection{EMPTY_CONNECTION};
     DrawableRectangle unfocusOverlay;
     OwnedArray<PluginWindow> activePluginWindows;
+    bool wasProfiling{false};
 
     juce::Point<int> trackAndSlotAt(const MouseEvent &e);
 
+    // Refresh the per-processor timing overlays while the DSP profiler is on (and once more after it's turned off to clear them).
+    void timerCallback() override {
+        const bool isProfiling = graph.isProfilingEnabled();
+        if (isProfiling || wasProfiling) repaint();
+        wasProfiling = isProfiling;
+    }
+
     int getTrackWidth() { return (getWidth() - View::TRACKS_MARGIN * 2) / View::NUM_VISIBLE_TRACKS; }
     int getProcessorHeight() { return (getHeight() - View::TRACK_LABEL_HEIGHT - View::TRACK_INPUT_HEIGHT) / (View::NUM_VISIBLE_PROCESSOR_SLOTS + 1); }
 
@@ -71,15 +80,21 @@ private:
         draggingGraphEditorConnection = nullptr;
     }
 
-    void onChildAdded(Track *track) override { connectors->updateConnectors(); }
+    // Every connector moves when a track or processor is added, removed or moved, so do it once per batch.
+    void updateConnectors() {
+        static const Identifier updateConnectorsUpdate("updateConnectors");
+        BatchedUpdates::callOrDefer(*connectors, updateConnectorsUpdate, [this] { connectors->updateConnectors(); });
+    }
+
+    void onChildAdded(Track *track) override { updateConnectors(); }
     void onChildChanged(Track *, const Identifier &) override {}
-    void onChildRemoved(Track *track, int oldIndex) override { connectors->updateConnectors(); }
-    void onOrderChanged() override { connectors->updateConnectors(); }
-    void onChildAdded(Processor *processor) override { connectors->updateConnectors(); }
-    void onChildRemoved(Processor *processor, int oldIndex) override { connectors->updateConnectors(); }
+    void onChildRemoved(Track *track, int oldIndex) override { updateConnectors(); }
+    void onOrderChanged() override { updateConnectors(); }
+    void onChildAdded(Processor *processor) override { updateConnectors(); }
+    void onChildRemoved(Processor *processor, int oldIndex) override { updateConnectors(); }
     void onChildChanged(Processor *processor, const Identifier &i) override {
         if (i == ProcessorIDs::slot) {
-            connectors->updateConnectors();
+            updateConnectors();
         } else if (i == ProcessorIDs::pluginWindowType) {
             const auto type = static_cast<PluginWindowType>(processor->getPluginWindowType());
             if (type == PluginWindowType::none) {
@@ -90,10 +105,10 @@ private:
         }
     }
     void valueTreeChildAdded(ValueTree &parent, ValueTree &child) override {
-        if (Connection::isType(child)) connectors->updateConnectors();
+        if (Connection::isType(child)) updateConnectors();
     }
     void valueTreeChildRemoved(ValueTree &parent, ValueTree &child, int oldIndex) override {
-        if (Connection::isType(child)) connectors->updateConnectors();
+        if (Connection::isType(child)) updateConnectors();
     }
     void valueTreePropertyChanged(ValueTree &tree, const Identifier &i) override {
         if (i == ViewIDs::gridSlotOffset) {
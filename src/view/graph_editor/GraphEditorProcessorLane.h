@@ -4,6 +4,7 @@
 #include "GraphEditorProcessorContainer.h"
 #include "ConnectorDragListener.h"
 #include "GraphEditorChannel.h"
+#include "BatchedUpdates.h"
 
 class GraphEditorProcessorLane : public Component, GraphEditorProcessorContainer, public ProcessorLane::Listener, public ValueTree::Listener {
 public:
@@ -14,22 +15,22 @@ public:
     void onChildAdded(Processor *processor) override {
         addAndMakeVisible(children.insert(processor->getIndex(), createEditorForProcessor(processor)));
         children.getUnchecked(processor->getIndex())->addMouseListener(this, true);
-        resized();
+        BatchedUpdates::resized(*this);
     }
     void onChildRemoved(Processor *processor, int oldIndex) override {
         children.getUnchecked(oldIndex)->removeMouseListener(this);
         children.remove(oldIndex);
-        resized();
+        BatchedUpdates::resized(*this);
     }
     void onOrderChanged() override {
         children.sort(*this);
-        resized();
+        BatchedUpdates::resized(*this);
         connectorDragListener.update();
     }
 
     void onChildChanged(Processor *processor, const Identifier &i) override {
         if (i == ProcessorIDs::slot) {
-            resized();
+            BatchedUpdates::resized(*this);
         }
     }
 
@@ -3,6 +3,7 @@
 #include "view/graph_editor/processor/TrackInputGraphEditorProcessor.h"
 #include "view/graph_editor/processor/TrackOutputGraphEditorProcessor.h"
 #include "GraphEditorProcessorLanes.h"
+#include "BatchedUpdates.h"
 
 class GraphEditorTrack : public Component, public ValueTree::Listener, public GraphEditorProcessorContainer, private Track::Listener {
 public:
@@ -39,12 +40,12 @@ private:
         if (processor->isTrackInputProcessor()) {
             trackInputProcessorView = std::make_unique<TrackInputGraphEditorProcessor>(processor, track, view, project, processorWrappers, connectorDragListener);
             addAndMakeVisible(trackInputProcessorView.get());
-            resized();
+            BatchedUpdates::resized(*this);
             onColourChanged();
         } else if (processor->isTrackOutputProcessor()) {
             trackOutputProcessorView = std::make_unique<TrackOutputGraphEditorProcessor>(processor, track, view, processorWrappers, connectorDragListener);
             addAndMakeVisible(trackOutputProcessorView.get());
-            resized();
+            BatchedUpdates::resized(*this);
             onColourChanged();
         }
     }
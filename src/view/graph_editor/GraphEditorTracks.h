@@ -4,6 +4,7 @@
 #include "GraphEditorTrack.h"
 #include "ConnectorDragListener.h"
 #include "model/StatefulList.h"
+#include "BatchedUpdates.h"
 
 class GraphEditorTracks : public Component,
                           public GraphEditorProcessorContainer,
@@ -95,15 +96,15 @@ private:
 
     void onChildAdded(Track *track) override {
         addAndMakeVisible(children.insert(track->getIndex(), new GraphEditorTrack(track, view, project, processorWrappers, pluginManager, connectorDragListener)));
-        resized();
+        BatchedUpdates::resized(*this);
     }
     void onChildRemoved(Track *track, int oldIndex) override {
         children.remove(oldIndex);
-        resized();
+        BatchedUpdates::resized(*this);
     }
     void onOrderChanged() override {
         children.sort(*this);
-        resized();
+        BatchedUpdates::resized(*this);
         connectorDragListener.update();
     }
 
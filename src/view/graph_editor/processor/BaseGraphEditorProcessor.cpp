@@ -30,6 +30,26 @@ void BaseGraphEditorProcessor::paint(Graphics &g) {
     g.fillRect(getBoxBounds());
 }
 
+void BaseGraphEditorProcessor::paintOverChildren(Graphics &g) {
+    auto *processorWrapper = getProcessorWrapper();
+    if (processorWrapper == nullptr) return;
+
+    const auto *timer = processorWrapper->timer;
+    if (timer == nullptr || !timer->isEnabled()) return;
+
+    const auto stats = timer->getStats().getSnapshot(processorWrapper->audioProcessor->getSampleRate());
+    if (stats.numBlocks == 0) return;
+
+    const auto text = String(stats.minMicros, 1) + " / " + String(stats.meanMicros, 1) + " / " + String(stats.p99Micros, 1) + " us\n" +
+                      String(stats.budgetShare * 100.0, 2) + "% of budget";
+    const auto textBounds = getBoxBounds().reduced(2).removeFromBottom(26);
+    g.setColour(Colours::black.withAlpha(0.6f));
+    g.fillRect(textBounds);
+    g.setColour(stats.budgetShare > 0.1 ? Colours::orange : Colours::lightgreen);
+    g.setFont(11.0f);
+    g.drawFittedText(text, textBounds, Justification::centred, 2);
+}
+
 bool BaseGraphEditorProcessor::hitTest(int x, int y) {
     for (auto *child : getChildren())
         if (child->getBounds().contains(x, y))
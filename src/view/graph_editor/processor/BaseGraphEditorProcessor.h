@@ -29,6 +29,7 @@ public:
     StatefulAudioProcessorWrapper *getProcessorWrapper() const { return processorWrappers.getProcessorWrapperForProcessor(processor); }
 
     void paint(Graphics &g) override;
+    void paintOverChildren(Graphics &g) override;
     bool hitTest(int x, int y) override;
     void resized() override;
 
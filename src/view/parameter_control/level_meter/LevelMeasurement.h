@@ -0,0 +1,170 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define FLOWGRID_LEVEL_MEASUREMENT_SSE 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define FLOWGRID_LEVEL_MEASUREMENT_NEON 1
+#endif
+
+#include <juce_audio_basics/juce_audio_basics.h>
+
+using namespace juce;
+
+/*!
+ *  The audio-thread kernels behind `LevelMeterSource`.
+ *
+ *  `PeakAndSumOfSquares::measure` reads each sample once, with SSE2 or NEON where available,
+ *  keeping two independent vector accumulators for each of the peak and the sum of squares.
+ *  `TruePeakDetector` and `KWeightingFilter` implement the ITU-R BS.1770-4 true-peak and loudness measurements,
+ *  for meters in `LevelMeterSource::Mode::loudness`.
+ *  None of them allocate.
+ */
+struct PeakAndSumOfSquares {
+    float peak{0.0f}, sumOfSquares{0.0f};
+
+    static PeakAndSumOfSquares measure(const float *samples, int numSamples) noexcept {
+        PeakAndSumOfSquares result;
+        int i = 0;
+#if FLOWGRID_LEVEL_MEASUREMENT_SSE
+        const auto absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+        auto peak0 = _mm_setzero_ps(), peak1 = _mm_setzero_ps(), sum0 = _mm_setzero_ps(), sum1 = _mm_setzero_ps();
+        for (; i + 8 <= numSamples; i += 8) {
+            const auto a = _mm_loadu_ps(samples + i), b = _mm_loadu_ps(samples + i + 4);
+            peak0 = _mm_max_ps(peak0, _mm_and_ps(a, absMask));
+            peak1 = _mm_max_ps(peak1, _mm_and_ps(b, absMask));
+            sum0 = _mm_add_ps(sum0, _mm_mul_ps(a, a));
+            sum1 = _mm_add_ps(sum1, _mm_mul_ps(b, b));
+        }
+        alignas(16) float peaks[4], sums[4];
+        _mm_store_ps(peaks, _mm_max_ps(peak0, peak1));
+        _mm_store_ps(sums, _mm_add_ps(sum0, sum1));
+        result.reduce(peaks, sums);
+#elif FLOWGRID_LEVEL_MEASUREMENT_NEON
+        auto peak0 = vdupq_n_f32(0.0f), peak1 = vdupq_n_f32(0.0f), sum0 = vdupq_n_f32(0.0f), sum1 = vdupq_n_f32(0.0f);
+        for (; i + 8 <= numSamples; i += 8) {
+            const auto a = vld1q_f32(samples + i), b = vld1q_f32(samples + i + 4);
+            peak0 = vmaxq_f32(peak0, vabsq_f32(a));
+            peak1 = vmaxq_f32(peak1, vabsq_f32(b));
+            sum0 = vmlaq_f32(sum0, a, a);
+            sum1 = vmlaq_f32(sum1, b, b);
+        }
+        float peaks[4], sums[4];
+        vst1q_f32(peaks, vmaxq_f32(peak0, peak1));
+        vst1q_f32(sums, vaddq_f32(sum0, sum1));
+        result.reduce(peaks, sums);
+#endif
+        for (; i < numSamples; ++i) {
+            result.peak = jmax(result.peak, std::abs(samples[i]));
+            result.sumOfSquares += samples[i] * samples[i];
+        }
+        return result;
+    }
+
+private:
+    void reduce(const float *peaks, const float *sums) noexcept {
+        peak = jmax(jmax(peaks[0], peaks[1]), jmax(peaks[2], peaks[3]));
+        sumOfSquares = (sums[0] + sums[1]) + (sums[2] + sums[3]);
+    }
+};
+
+// Peak magnitude of the signal upsampled 4x, using the polyphase interpolation filter of ITU-R BS.1770-4, Annex 2.
+struct TruePeakDetector {
+    void reset() noexcept {
+        history = {};
+        position = 0;
+    }
+
+    float process(const float *samples, int numSamples) noexcept {
+        float peak = 0.0f;
+        for (int i = 0; i < numSamples; ++i) {
+            // Each sample is written twice, so the last `NUM_TAPS` samples are always contiguous, newest first.
+            position = (position + NUM_TAPS - 1) % NUM_TAPS;
+            history[size_t(position)] = history[size_t(position + NUM_TAPS)] = samples[i];
+            const float *window = history.data() + position;
+            for (const auto &phase : PHASES) {
+                float sample = 0.0f;
+                for (size_t tap = 0; tap < size_t(NUM_TAPS); ++tap)
+                    sample += phase[tap] * window[tap];
+                peak = jmax(peak, std::abs(sample));
+            }
+        }
+        return peak;
+    }
+
+private:
+    static constexpr int NUM_TAPS = 12;
+    static constexpr float PHASES[4][NUM_TAPS]{
+        {0.0017089843750f, 0.0109863281250f, -0.0196533203125f, 0.0332031250000f, -0.0594482421875f, 0.1373291015625f,
+         0.9721679687500f, -0.1022949218750f, 0.0476074218750f, -0.0266113281250f, 0.0148925781250f, -0.0083007812500f},
+        {-0.0291748046875f, 0.0292968750000f, -0.0517578125000f, 0.0891113281250f, -0.1665039062500f, 0.4650878906250f,
+         0.7797851562500f, -0.2003173828125f, 0.1015625000000f, -0.0582275390625f, 0.0330810546875f, -0.0189208984375f},
+        {-0.0189208984375f, 0.0330810546875f, -0.0582275390625f, 0.1015625000000f, -0.2003173828125f, 0.7797851562500f,
+         0.4650878906250f, -0.1665039062500f, 0.0891113281250f, -0.0517578125000f, 0.0292968750000f, -0.0291748046875f},
+        {-0.0083007812500f, 0.0148925781250f, -0.0266113281250f, 0.0476074218750f, -0.1022949218750f, 0.9721679687500f,
+         0.1373291015625f, -0.0594482421875f, 0.0332031250000f, -0.0196533203125f, 0.0109863281250f, 0.0017089843750f},
+    };
+
+    std::array<float, 2 * NUM_TAPS> history{};
+    int position{0};
+};
+
+/*!
+ *  The ITU-R BS.1770-4 K-weighting pre-filter (a high shelf followed by a high-pass), for each sample rate.
+ *  The mean square of the filtered signal is the channel's contribution to its loudness:
+ *  `LUFS = -0.691 + 10 * log10(sum of channel mean squares)`.
+ */
+struct KWeightingFilter {
+    void prepare(double sampleRate) {
+        // Coefficients from the analog prototypes, as in libebur128.
+        double k = std::tan(MathConstants<double>::pi * 1681.974450955533 / sampleRate);
+        double q = 0.7071752369554196;
+        const double vh = std::pow(10.0, 3.999843853973347 / 20.0), vb = std::pow(vh, 0.4996667741545416);
+        double a0 = 1.0 + k / q + k * k;
+        shelf = {(vh + vb * k / q + k * k) / a0, 2.0 * (k * k - vh) / a0, (vh - vb * k / q + k * k) / a0,
+                 2.0 * (k * k - 1.0) / a0, (1.0 - k / q + k * k) / a0};
+
+        k = std::tan(MathConstants<double>::pi * 38.13547087602444 / sampleRate);
+        q = 0.5003270373238773;
+        a0 = 1.0 + k / q + k * k;
+        highPass = {1.0, -2.0, 1.0, 2.0 * (k * k - 1.0) / a0, (1.0 - k / q + k * k) / a0};
+        reset();
+    }
+
+    void reset() noexcept {
+        shelf.reset();
+        highPass.reset();
+    }
+
+    // Sum of squares of the K-weighted samples.
+    float process(const float *samples, int numSamples) noexcept {
+        double sumOfSquares = 0.0;
+        for (int i = 0; i < numSamples; ++i) {
+            const double weighted = highPass.process(shelf.process(double(samples[i])));
+            sumOfSquares += weighted * weighted;
+        }
+        return float(sumOfSquares);
+    }
+
+private:
+    // Transposed direct form II, normalized so `a0 == 1`.
+    struct Biquad {
+        double b0{1.0}, b1{0.0}, b2{0.0}, a1{0.0}, a2{0.0};
+        double z1{0.0}, z2{0.0};
+
+        void reset() noexcept { z1 = z2 = 0.0; }
+
+        double process(double x) noexcept {
+            const double y = b0 * x + z1;
+            z1 = b1 * x - a1 * y + z2;
+            z2 = b2 * x - a2 * y;
+            return y;
+        }
+    };
+
+    Biquad shelf, highPass;
+};
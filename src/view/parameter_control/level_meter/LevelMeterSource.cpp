@@ -1,15 +1,19 @@
 #include "LevelMeterSource.h"
 
 /**
- This is called from the GUI. If processing was stalled, this will pump zeroes into the buffer,
- until the readings return to zero.
+ This is called from the GUI. If processing was stalled, the levels it reads decay as though silence
+ was measured, until they return to zero.
  */
 void LevelMeterSource::decayIfNeeded() {
-    int64 time = Time::currentTimeMillis();
-    if (time - lastMeasurement > 100) {
-        lastMeasurement = time;
-        for (auto &level : levels) {
-            level.setLevels(lastMeasurement, 0.0f, 0.0f, holdMSecs);
-        }
+    const int64 measurement = lastMeasurement.load(std::memory_order_relaxed);
+    if (measurement != lastSeenMeasurement) {
+        lastSeenMeasurement = lastDecay = measurement;
+        numDecayedBlocks = 0;
     }
-}
\ No newline at end of file
+
+    const int64 time = Time::currentTimeMillis();
+    if (time - lastDecay > 100) {
+        lastDecay = time;
+        numDecayedBlocks = jmin(numDecayedBlocks + 1, RMS_WINDOW);
+    }
+}
@@ -1,117 +1,144 @@
 #pragma once
 
 #include <atomic>
-#include <vector>
+#include <array>
 
 #include <juce_audio_basics/juce_audio_basics.h>
+#include "LevelMeasurement.h"
 
 using namespace juce;
 
+/*!
+ *  Peak and RMS levels of a processor's output, measured on the audio thread and read by the GUI.
+ *
+ *  The audio thread owns the peak-hold and RMS-window state of each channel, and publishes the resulting levels
+ *  through per-channel atomics. Channel storage has a fixed capacity, and the channel count only changes in `prepare`,
+ *  so neither side ever allocates or locks, and the GUI never writes anything the audio thread reads.
+ *
+ *  In `Mode::loudness`, the peak is the 4x-oversampled true peak and the RMS is of the K-weighted signal (see `LevelMeasurement.h`).
+ */
 class LevelMeterSource {
 public:
-    LevelMeterSource() : holdMSecs(500), lastMeasurement(0), suspended(false) {}
+    static constexpr int MAX_CHANNELS = 8;
+
+    enum class Mode { samplePeak, loudness };
+
+    LevelMeterSource() = default;
 
     ~LevelMeterSource() { masterReference.clear(); }
 
+    // Call from `prepareToPlay`. Channels beyond `MAX_CHANNELS` are not measured.
+    void prepare(int numChannels, double sampleRate, Mode mode = Mode::samplePeak) {
+        jassert(numChannels <= MAX_CHANNELS);
+        this->mode = mode;
+        for (auto &channel : channels) channel.prepare(sampleRate);
+        this->numChannels = jlimit(0, MAX_CHANNELS, numChannels);
+    }
+
+    // Called on the audio thread.
     void measureBlock(const AudioBuffer<float> &buffer) {
-        lastMeasurement = Time::currentTimeMillis();
-        if (suspended) return;
-
-        int numChannels = buffer.getNumChannels();
-        int numSamples = buffer.getNumSamples();
-        levels.resize(static_cast<unsigned long>(numChannels));
-        for (int channel = 0; channel < numChannels; ++channel) {
-            auto channelIndex = static_cast<unsigned long>(channel);
-            levels[channelIndex].setLevels(lastMeasurement,
-                                           buffer.getMagnitude(channel, 0, numSamples),
-                                           buffer.getRMSLevel(channel, 0, numSamples),
-                                           holdMSecs);
-        }
+        const auto time = Time::currentTimeMillis();
+        const int numSamples = buffer.getNumSamples();
+        const int numMeasuredChannels = jmin(buffer.getNumChannels(), numChannels.load(std::memory_order_relaxed));
+        for (int channel = 0; channel < numMeasuredChannels; ++channel)
+            channels[size_t(channel)].measure(buffer.getReadPointer(channel), numSamples, mode, time);
+        lastMeasurement.store(time, std::memory_order_relaxed);
     }
 
     /**
-     This is called from the GUI. If processing was stalled, this will pump zeroes into the buffer,
-     until the readings return to zero.
+     This is called from the GUI. If processing was stalled, the levels it reads decay as though silence
+     was measured, until they return to zero.
      */
     void decayIfNeeded();
 
     /**
      This is the max level as displayed by the little line above the RMS bar.
-     It is reset by \see setMaxHoldMS.
+     It is held for `HOLD_MILLIS` after each new maximum.
      */
-    float getMaxLevel(unsigned int channel) const { return levels[channel].max; }
+    float getMaxLevel(unsigned int channel) const {
+        return numDecayedBlocks > 0 ? 0.0f : channels[channel].max.load(std::memory_order_relaxed);
+    }
 
     /**
      This is the RMS level that the bar will indicate. It is
-     summed over rmsWindow number of blocks/measureBlock calls.
+     summed over `RMS_WINDOW` number of blocks/measureBlock calls.
      */
-    float getRMSLevel(unsigned int channel) const { return levels[channel].getAvgRMS(); }
+    float getRMSLevel(unsigned int channel) const {
+        const auto rms = channels[channel].rms.load(std::memory_order_relaxed);
+        if (numDecayedBlocks == 0) return rms;
+        // As though the last `numDecayedBlocks` blocks of the window were silent.
+        return rms * std::sqrt(float(jmax(0, RMS_WINDOW - numDecayedBlocks)) / float(RMS_WINDOW));
+    }
 
-    unsigned int getNumChannels() const { return static_cast<unsigned int>(levels.size()); }
+    unsigned int getNumChannels() const { return static_cast<unsigned int>(numChannels.load(std::memory_order_relaxed)); }
 
 private:
-    class ChannelData {
-    public:
-        explicit ChannelData(unsigned long rmsWindow = 8) :
-                max(), maxOverall(), clip(false), hold(0), rmsHistory(rmsWindow, 0.0), rmsSum(0.0), rmsPtr(0) {}
-
-        ChannelData(const ChannelData &other) :
-                max(other.max.load()), maxOverall(other.maxOverall.load()), clip(other.clip.load()),
-                hold(other.hold.load()), rmsHistory(8, 0.0), rmsSum(0.0), rmsPtr(0) {}
-
-        std::atomic<float> max;
-        std::atomic<float> maxOverall;
-        std::atomic<bool> clip;
-
-        float getAvgRMS() const {
-            if (!rmsHistory.empty()) return sqrtf(rmsSum / static_cast<float>(rmsHistory.size()));
-            return sqrtf(rmsSum);
+    static constexpr int RMS_WINDOW = 8;
+    static constexpr int64 HOLD_MILLIS = 500;
+
+    struct ChannelData {
+        // Published to the GUI.
+        std::atomic<float> max{0.0f}, rms{0.0f};
+
+        void prepare(double sampleRate) {
+            max = 0.0f;
+            rms = 0.0f;
+            hold = 0;
+            rmsHistory = {};
+            rmsSum = 0.0f;
+            rmsIndex = 0;
+            truePeakDetector.reset();
+            kWeightingFilter.prepare(sampleRate);
         }
 
-        void setLevels(const int64 time, const float newMax, const float newRms, const int64 holdMSecs) {
-            if (newMax > 1.0 || newRms > 1.0)
-                clip = true;
-
-            maxOverall = fmaxf(maxOverall, newMax);
-            if (newMax >= max) {
-                max = std::min(1.0f, newMax);
-                hold = time + holdMSecs;
-            } else if (time > hold) {
-                max = std::min(1.0f, newMax);
+        void measure(const float *samples, int numSamples, Mode mode, int64 time) {
+            float peak, sumOfSquares;
+            if (mode == Mode::loudness) {
+                peak = truePeakDetector.process(samples, numSamples);
+                sumOfSquares = kWeightingFilter.process(samples, numSamples);
+            } else {
+                const auto measured = PeakAndSumOfSquares::measure(samples, numSamples);
+                peak = measured.peak;
+                sumOfSquares = measured.sumOfSquares;
             }
-            pushNextRMS(std::min(1.0f, newRms));
-        }
-
-        void setRMSsize(unsigned long numBlocks) {
-            rmsHistory.assign(numBlocks, 0.0f);
-            rmsSum = 0.0;
-            numBlocks > 1 ? (rmsPtr %= rmsHistory.size()) : (rmsPtr = 0);
+            setLevels(time, peak, numSamples > 0 ? std::sqrt(sumOfSquares / float(numSamples)) : 0.0f);
         }
 
     private:
-        void pushNextRMS(const float newRMS) {
-            const float squaredRMS = std::min(newRMS * newRMS, 1.0f);
-            if (!rmsHistory.empty()) {
-                rmsSum = rmsSum + squaredRMS - rmsHistory[rmsPtr];
-                rmsHistory[rmsPtr] = squaredRMS;
-                rmsPtr = (rmsPtr + 1) % rmsHistory.size();
-            } else {
-                rmsSum = squaredRMS;
+        // Audio thread only.
+        int64 hold{0};
+        std::array<float, RMS_WINDOW> rmsHistory{};
+        float rmsSum{0.0f};
+        size_t rmsIndex{0};
+        TruePeakDetector truePeakDetector;
+        KWeightingFilter kWeightingFilter;
+
+        void setLevels(int64 time, float newMax, float newRms) {
+            const auto currentMax = max.load(std::memory_order_relaxed);
+            if (newMax >= currentMax) {
+                max.store(std::min(1.0f, newMax), std::memory_order_relaxed);
+                hold = time + HOLD_MILLIS;
+            } else if (time > hold) {
+                max.store(std::min(1.0f, newMax), std::memory_order_relaxed);
             }
-        }
 
-        std::atomic<int64> hold;
-        std::vector<float> rmsHistory;
-        std::atomic<float> rmsSum;
-        std::vector<float>::size_type rmsPtr;
+            const float squaredRms = std::min(newRms * newRms, 1.0f);
+            rmsSum = std::max(0.0f, rmsSum + squaredRms - rmsHistory[rmsIndex]);
+            rmsHistory[rmsIndex] = squaredRms;
+            rmsIndex = (rmsIndex + 1) % rmsHistory.size();
+            rms.store(std::sqrt(rmsSum / float(RMS_WINDOW)), std::memory_order_relaxed);
+        }
     };
 
     WeakReference<LevelMeterSource>::Master masterReference;
 
     friend class WeakReference<LevelMeterSource>;
 
-    std::vector<ChannelData> levels;
-    int64 holdMSecs;
-    std::atomic<int64> lastMeasurement;
-    bool suspended;
+    std::array<ChannelData, MAX_CHANNELS> channels;
+    std::atomic<int> numChannels{0};
+    Mode mode{Mode::samplePeak};
+    std::atomic<int64> lastMeasurement{0};
+    // Message thread only.
+    int64 lastSeenMeasurement{0}, lastDecay{0};
+    int numDecayedBlocks{0};
 };
@@ -7,7 +7,7 @@ Push2Component::Push2Component(View &view, Tracks &tracks, Connections &connecti
           project(project), connections(connections), processorWrappers(processorWrappers),
           processorView(view, tracks, project, push2MidiCommunicator), processorSelector(view, tracks, project, push2MidiCommunicator),
           mixerView(view, tracks, project, processorWrappers, push2MidiCommunicator), push2NoteModePadLedManager(tracks, push2MidiCommunicator) {
-    startTimer(60);
+    startTimerHz(60);
 
     addChildComponent(processorView);
     addChildComponent(processorSelector);
@@ -165,10 +165,10 @@ void Push2Component::updateEnabledPush2Buttons() {
 void Push2Component::drawFrame() {
     static const juce::Colour CLEAR_COLOR = juce::Colour(0xff000000);
 
-    auto &g = displayBridge.getGraphics();
-    g.fillAll(CLEAR_COLOR);
-    paintEntireComponent(g, true);
-    displayBridge.writeFrameToDisplay();
+    displayBridge.renderFrame([this](Graphics &g) {
+        g.fillAll(CLEAR_COLOR);
+        paintEntireComponent(g, true);
+    });
 }
 
 void Push2Component::updatePush2SelectionDependentButtons() {
@@ -244,11 +244,21 @@ void Push2Component::showChild(Push2ComponentBase *child) {
         currentlyViewingChild->setVisible(true);
 }
 
+static const Identifier selectionDependentButtonsUpdate("updatePush2SelectionDependentButtons");
+static const Identifier noteModePadLedManagerVisibilityUpdate("updatePush2NoteModePadLedManagerVisibility");
+
+void Push2Component::batchUpdatePush2SelectionDependentButtons() {
+    BatchedUpdates::callOrDefer(*this, selectionDependentButtonsUpdate, [this] { updatePush2SelectionDependentButtons(); });
+}
+void Push2Component::batchUpdatePush2NoteModePadLedManagerVisibility() {
+    BatchedUpdates::callOrDefer(*this, noteModePadLedManagerVisibilityUpdate, [this] { updatePush2NoteModePadLedManagerVisibility(); });
+}
+
 void Push2Component::onChildAdded(Track *) {
-    updatePush2SelectionDependentButtons();
+    batchUpdatePush2SelectionDependentButtons();
 }
 void Push2Component::onChildRemoved(Track *, int oldIndex) {
-    updatePush2SelectionDependentButtons();
+    batchUpdatePush2SelectionDependentButtons();
     if (tracks.getFocusedTrack() == nullptr) {
         showChild(nullptr);
         processorView.processorFocused(nullptr, nullptr);
@@ -256,21 +266,21 @@ void Push2Component::onChildRemoved(Track *, int oldIndex) {
 }
 void Push2Component::onChildAdded(Processor *) {
     updateFocusedProcessor();
-    updatePush2SelectionDependentButtons();
+    batchUpdatePush2SelectionDependentButtons();
 }
 void Push2Component::onChildRemoved(Processor *, int oldIndex) {
     updateFocusedProcessor();
-    updatePush2SelectionDependentButtons();
+    batchUpdatePush2SelectionDependentButtons();
 }
 
 void Push2Component::valueTreeChildAdded(ValueTree &parent, ValueTree &child) {
     if (Connection::isType(child)) {
-        updatePush2NoteModePadLedManagerVisibility();
+        batchUpdatePush2NoteModePadLedManagerVisibility();
     }
 }
 void Push2Component::valueTreeChildRemoved(ValueTree &exParent, ValueTree &child, int) {
     if (Connection::isType(child)) {
-        updatePush2NoteModePadLedManagerVisibility();
+        batchUpdatePush2NoteModePadLedManagerVisibility();
     }
 }
 void Push2Component::valueTreePropertyChanged(ValueTree &tree, const Identifier &i) {
@@ -24,6 +24,9 @@ public:
 
     void setVisible(bool visible) override;
 
+    // Connects to the Push 2 display if it's been plugged in.
+    void usbDevicesChanged() { displayBridge.usbDevicesChanged(); }
+
     void shiftPressed() override;
     void shiftReleased() override;
     void masterEncoderRotated(float changeAmount) override;
@@ -56,13 +59,15 @@ private:
 
     void timerCallback() override { drawFrame(); }
 
-    // Render a frame and send it to the Push 2 display (if it's available)
+    // Paint a frame and hand it off to be sent to the Push 2 display (if it's available)
     void drawFrame();
 
     bool canNavigateInDirection(int direction) const;
 
     void updatePush2SelectionDependentButtons();
     void updatePush2NoteModePadLedManagerVisibility();
+    void batchUpdatePush2SelectionDependentButtons();
+    void batchUpdatePush2NoteModePadLedManagerVisibility();
     void updateFocusedProcessor();
 
     void showChild(Push2ComponentBase *child);
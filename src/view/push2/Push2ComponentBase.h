@@ -2,6 +2,7 @@
 
 #include "push2/Push2MidiCommunicator.h"
 #include "Push2Listener.h"
+#include "BatchedUpdates.h"
 
 using Push2 = Push2MidiCommunicator;
 
@@ -17,6 +18,12 @@ public:
 
     virtual void updateEnabledPush2Buttons() = 0;
 
+    // Only updates the buttons once for a batch of track or processor changes.
+    void batchUpdateEnabledPush2Buttons() {
+        static const Identifier update("updateEnabledPush2Buttons");
+        BatchedUpdates::callOrDefer(*this, update, [this] { updateEnabledPush2Buttons(); });
+    }
+
     void deviceConnected() override { updateEnabledPush2Buttons(); }
 
     // Let inheritors implement only what they need.
@@ -17,10 +17,10 @@ public:
     void updateEnabledPush2Buttons() override;
 
 protected:
-    void onChildAdded(Track *) override { updateEnabledPush2Buttons(); }
-    void onChildRemoved(Track *, int oldIndex) override { updateEnabledPush2Buttons(); }
+    void onChildAdded(Track *) override { batchUpdateEnabledPush2Buttons(); }
+    void onChildRemoved(Track *, int oldIndex) override { batchUpdateEnabledPush2Buttons(); }
     void onChildChanged(Track *, const Identifier &i) override;
-    void onOrderChanged() override { updateEnabledPush2Buttons(); }
+    void onOrderChanged() override { batchUpdateEnabledPush2Buttons(); }
 
     virtual void trackSelected(Track *track) { updateEnabledPush2Buttons(); }
 